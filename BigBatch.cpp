@@ -0,0 +1,520 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#include "BigBatch.h"
+#include "BigKernels.h"
+#include "BigThreadPool.h"
+#include <algorithm>
+#include <functional>
+
+// the vector kernels need AVX2 for 64-bit lanes and they're left out the same
+// way as the other vector kernels (BIGNUMBER_NO_SIMD)
+#if BIGNUMBER_LIMB_BITS == 64 && (defined(__x86_64__) || defined(_M_X64)) && !defined(BIGNUMBER_NO_SIMD)
+#define BIGNUMBER_BATCH_AVX2
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#define BIGNUMBER_TARGET(x) __attribute__((target(x))) // lets a function use instructions the rest of the file can't
+#else
+#define BIGNUMBER_TARGET(x)
+#endif
+#endif
+
+namespace BigNumber
+{
+	namespace BatchKernels
+	{
+		// the values every integer uses for a modulus (it isn't in the anonymous
+		// namespace since powMod's lambda holds one, and that has to be the same
+		// type everywhere when the library is header only)
+		struct Modulus
+		{
+			limb n[maxLimbs]; // the modulus
+			limb r2[maxLimbs]; // R^2 % n where R is 2^(32 * limbs)
+			limb inverse; // -1 / n % 2^32
+		};
+
+		namespace detail
+		{
+			typedef std::uint64_t wideLimb; // double width type
+			BIGNUMBER_INLINE const unsigned int limbBits = 32; // number of bits in a limb
+			BIGNUMBER_INLINE const size_t lanes = 4; // number of integers in a vector
+
+			// takes n off r when r (with high as one more limb) isn't less than n
+			BIGNUMBER_INLINE void reduce(limb *r, limb high, const limb *n, size_t limbs)
+			{
+				limb diff[maxLimbs];
+				wideLimb borrow = 0;
+
+				for (size_t j = 0; j < limbs; ++j)
+				{
+					wideLimb d = (wideLimb)r[j] - n[j] - borrow;
+					diff[j] = (limb)d;
+					borrow = d >> 63;
+				}
+
+				if (high != 0 || borrow == 0)
+					std::copy(diff, diff + limbs, r);
+			}
+
+			// sets up the values for montgomery multiplication. r2 is found by
+			// doubling one until it's R^2 so it only needs adds and subtracts
+			BIGNUMBER_INLINE void setModulus(Modulus &m, const limb *n, size_t limbs)
+			{
+				std::copy(n, n + limbs, m.n);
+
+				limb inverse = n[0]; // right for the lowest 3 bits since n is odd
+
+				for (int i = 0; i < 4; ++i)
+					inverse *= 2 - n[0] * inverse; // every step doubles the number of right bits
+
+				m.inverse = (limb)0 - inverse;
+
+				limb *r = m.r2;
+				std::fill(r, r + limbs, 0);
+				r[0] = 1;
+				reduce(r, 0, n, limbs); // n can be one
+
+				for (size_t i = 0; i < 2 * limbBits * limbs; ++i)
+				{
+					// r = 2r and then take off n if it's too big (r < n so 2r < 2n)
+					limb high = r[limbs - 1] >> (limbBits - 1);
+
+					for (size_t j = limbs - 1; j > 0; --j)
+						r[j] = r[j] << 1 | r[j - 1] >> (limbBits - 1);
+
+					r[0] <<= 1;
+					reduce(r, high, n, limbs);
+				}
+			}
+
+			// the portable kernels do one integer at a time. the integer
+			// is copied out of the batch so the limbs are next to each other
+
+			BIGNUMBER_INLINE void gather(limb *r, const limb *a, size_t limbs, size_t count, size_t index)
+			{
+				for (size_t j = 0; j < limbs; ++j)
+					r[j] = a[j * count + index];
+			}
+
+			BIGNUMBER_INLINE void scatter(limb *r, const limb *a, size_t limbs, size_t count, size_t index)
+			{
+				for (size_t j = 0; j < limbs; ++j)
+					r[j * count + index] = a[j];
+			}
+
+			BIGNUMBER_INLINE void addPortable(limb *r, const limb *a, const limb *b, size_t limbs, size_t count, size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+				{
+					wideLimb carry = 0;
+
+					for (size_t j = 0; j < limbs; ++j)
+					{
+						carry += (wideLimb)a[j * count + i] + b[j * count + i];
+						r[j * count + i] = (limb)carry;
+						carry >>= limbBits;
+					}
+				}
+			}
+
+			// mulLow keeps the low limbs of a * b (r can't be a or b)
+			BIGNUMBER_INLINE void mulLow(limb *r, const limb *a, const limb *b, size_t limbs)
+			{
+				std::fill(r, r + limbs, 0);
+
+				for (size_t i = 0; i < limbs; ++i)
+				{
+					wideLimb carry = 0;
+
+					for (size_t j = 0; i + j < limbs; ++j)
+					{
+						carry += (wideLimb)a[i] * b[j] + r[i + j];
+						r[i + j] = (limb)carry;
+						carry >>= limbBits;
+					}
+				}
+			}
+
+			BIGNUMBER_INLINE void mulPortable(limb *r, const limb *a, const limb *b, size_t limbs, size_t count, size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+				{
+					limb x[maxLimbs], y[maxLimbs], z[maxLimbs];
+					gather(x, a, limbs, count, i);
+					gather(y, b, limbs, count, i);
+					mulLow(z, x, y, limbs);
+					scatter(r, z, limbs, count, i);
+				}
+			}
+
+			// montgomery multiplication (r = a * b / R % n). a has to be less
+			// than R and b less than n. r can be a or b
+			BIGNUMBER_INLINE void montgomery(limb *r, const limb *a, const limb *b, const Modulus &m, size_t limbs)
+			{
+				limb t[maxLimbs + 2] = {};
+
+				for (size_t i = 0; i < limbs; ++i)
+				{
+					// t += a * b[i]
+					wideLimb carry = 0;
+
+					for (size_t j = 0; j < limbs; ++j)
+					{
+						carry += (wideLimb)a[j] * b[i] + t[j];
+						t[j] = (limb)carry;
+						carry >>= limbBits;
+					}
+
+					carry += t[limbs];
+					t[limbs] = (limb)carry;
+					t[limbs + 1] = (limb)(carry >> limbBits);
+
+					// t = (t + q * n) / 2^32 where q makes the lowest limb zero
+					limb q = t[0] * m.inverse;
+					carry = ((wideLimb)q * m.n[0] + t[0]) >> limbBits;
+
+					for (size_t j = 1; j < limbs; ++j)
+					{
+						carry += (wideLimb)q * m.n[j] + t[j];
+						t[j - 1] = (limb)carry;
+						carry >>= limbBits;
+					}
+
+					carry += t[limbs];
+					t[limbs - 1] = (limb)carry;
+					t[limbs] = t[limbs + 1] + (limb)(carry >> limbBits);
+				}
+
+				// t < 2n so taking off n once is enough
+				reduce(t, t[limbs], m.n, limbs);
+				std::copy(t, t + limbs, r);
+			}
+
+			BIGNUMBER_INLINE void powModPortable(limb *r, const limb *a, const limb *e, const Modulus &m, size_t limbs, size_t count, size_t first, size_t last)
+			{
+				limb one[maxLimbs] = {1};
+
+				for (size_t i = first; i < last; ++i)
+				{
+					limb base[maxLimbs], exponent[maxLimbs], x[maxLimbs];
+					gather(base, a, limbs, count, i);
+					gather(exponent, e, limbs, count, i);
+
+					// put the base and one in montgomery form
+					montgomery(base, base, m.r2, m, limbs);
+					montgomery(x, m.r2, one, m, limbs);
+
+					for (size_t j = limbs; j-- > 0;)
+					{
+						for (unsigned int bit = limbBits; bit-- > 0;)
+						{
+							montgomery(x, x, x, m, limbs);
+
+							if ((exponent[j] >> bit) & 1)
+								montgomery(x, x, base, m, limbs);
+						}
+					}
+
+					// take it out of montgomery form
+					montgomery(x, x, one, m, limbs);
+					scatter(r, x, limbs, count, i);
+				}
+			}
+
+#ifdef BIGNUMBER_BATCH_AVX2
+			// the AVX2 kernels do four integers at a time with every limb in a
+			// 64-bit lane so the carries and products have room
+
+			BIGNUMBER_TARGET("avx2") inline __m256i loadLanes(const limb *a)
+			{
+				return _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)a));
+			}
+
+			BIGNUMBER_TARGET("avx2") inline void storeLanes(limb *r, __m256i value)
+			{
+				// the low halves of the lanes go in the lower 128 bits
+				__m256i packed = _mm256_permutevar8x32_epi32(value, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+				_mm_storeu_si128((__m128i *)r, _mm256_castsi256_si128(packed));
+			}
+
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("avx2") void addAvx2(limb *r, const limb *a, const limb *b, size_t limbs, size_t count, size_t first, size_t last)
+			{
+				const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFF);
+
+				for (size_t i = first; i + lanes <= last; i += lanes)
+				{
+					__m256i carry = _mm256_setzero_si256();
+
+					for (size_t j = 0; j < limbs; ++j)
+					{
+						carry = _mm256_add_epi64(carry, _mm256_add_epi64(loadLanes(a + j * count + i), loadLanes(b + j * count + i)));
+						storeLanes(r + j * count + i, _mm256_and_si256(carry, mask));
+						carry = _mm256_srli_epi64(carry, 32);
+					}
+				}
+			}
+
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("avx2") void mulAvx2(limb *r, const limb *a, const limb *b, size_t limbs, size_t count, size_t first, size_t last)
+			{
+				const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFF);
+				__m256i x[maxLimbs], y[maxLimbs], z[maxLimbs];
+
+				for (size_t i = first; i + lanes <= last; i += lanes)
+				{
+					for (size_t j = 0; j < limbs; ++j)
+					{
+						x[j] = loadLanes(a + j * count + i);
+						y[j] = loadLanes(b + j * count + i);
+						z[j] = _mm256_setzero_si256();
+					}
+
+					for (size_t j = 0; j < limbs; ++j)
+					{
+						__m256i carry = _mm256_setzero_si256();
+
+						for (size_t k = 0; j + k < limbs; ++k)
+						{
+							carry = _mm256_add_epi64(carry, _mm256_add_epi64(_mm256_mul_epu32(x[j], y[k]), z[j + k]));
+							z[j + k] = _mm256_and_si256(carry, mask);
+							carry = _mm256_srli_epi64(carry, 32);
+						}
+					}
+
+					for (size_t j = 0; j < limbs; ++j)
+						storeLanes(r + j * count + i, z[j]);
+				}
+			}
+
+			// works the same as montgomery above on four integers
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("avx2") void montgomeryAvx2(__m256i *r, const __m256i *a, const __m256i *b, const __m256i *n, __m256i inverse, size_t limbs)
+			{
+				const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFF);
+				__m256i t[maxLimbs + 2];
+
+				for (size_t j = 0; j < limbs + 2; ++j)
+					t[j] = _mm256_setzero_si256();
+
+				for (size_t i = 0; i < limbs; ++i)
+				{
+					__m256i carry = _mm256_setzero_si256();
+
+					for (size_t j = 0; j < limbs; ++j)
+					{
+						carry = _mm256_add_epi64(carry, _mm256_add_epi64(_mm256_mul_epu32(a[j], b[i]), t[j]));
+						t[j] = _mm256_and_si256(carry, mask);
+						carry = _mm256_srli_epi64(carry, 32);
+					}
+
+					carry = _mm256_add_epi64(carry, t[limbs]);
+					t[limbs] = _mm256_and_si256(carry, mask);
+					t[limbs + 1] = _mm256_srli_epi64(carry, 32);
+
+					__m256i q = _mm256_and_si256(_mm256_mul_epu32(t[0], inverse), mask);
+					carry = _mm256_srli_epi64(_mm256_add_epi64(_mm256_mul_epu32(q, n[0]), t[0]), 32);
+
+					for (size_t j = 1; j < limbs; ++j)
+					{
+						carry = _mm256_add_epi64(carry, _mm256_add_epi64(_mm256_mul_epu32(q, n[j]), t[j]));
+						t[j - 1] = _mm256_and_si256(carry, mask);
+						carry = _mm256_srli_epi64(carry, 32);
+					}
+
+					carry = _mm256_add_epi64(carry, t[limbs]);
+					t[limbs - 1] = _mm256_and_si256(carry, mask);
+					t[limbs] = _mm256_add_epi64(t[limbs + 1], _mm256_srli_epi64(carry, 32));
+				}
+
+				// work out t - n in every lane and keep it where it didn't borrow
+				__m256i diff[maxLimbs];
+				__m256i borrow = _mm256_setzero_si256();
+
+				for (size_t j = 0; j < limbs; ++j)
+				{
+					__m256i d = _mm256_sub_epi64(_mm256_sub_epi64(t[j], n[j]), borrow);
+					diff[j] = _mm256_and_si256(d, mask);
+					borrow = _mm256_srli_epi64(d, 63);
+				}
+
+				borrow = _mm256_sub_epi64(borrow, t[limbs]); // t[limbs] is zero or one
+				__m256i keep = _mm256_cmpeq_epi64(borrow, _mm256_set1_epi64x(1));
+
+				for (size_t j = 0; j < limbs; ++j)
+					r[j] = _mm256_blendv_epi8(diff[j], t[j], keep);
+			}
+
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("avx2") void powModAvx2(limb *r, const limb *a, const limb *e, const Modulus &m, size_t limbs, size_t count, size_t first, size_t last)
+			{
+				__m256i n[maxLimbs], r2[maxLimbs], one[maxLimbs];
+				__m256i base[maxLimbs], x[maxLimbs], y[maxLimbs];
+				const __m256i inverse = _mm256_set1_epi64x(m.inverse);
+
+				for (size_t j = 0; j < limbs; ++j)
+				{
+					n[j] = _mm256_set1_epi64x(m.n[j]);
+					r2[j] = _mm256_set1_epi64x(m.r2[j]);
+					one[j] = _mm256_set1_epi64x(j == 0);
+				}
+
+				for (size_t i = first; i + lanes <= last; i += lanes)
+				{
+					for (size_t j = 0; j < limbs; ++j)
+						base[j] = loadLanes(a + j * count + i);
+
+					montgomeryAvx2(base, base, r2, n, inverse, limbs);
+					montgomeryAvx2(x, r2, one, n, inverse, limbs);
+
+					// start at the highest limb of the exponents that isn't zero
+					size_t top = limbs;
+
+					while (top > 0 && _mm_testz_si128(_mm_loadu_si128((const __m128i *)(e + (top - 1) * count + i)), _mm_set1_epi32(-1)))
+						--top;
+
+					for (size_t j = top; j-- > 0;)
+					{
+						__m256i exponent = loadLanes(e + j * count + i);
+
+						for (int bit = (int)limbBits - 1; bit >= 0; --bit)
+						{
+							// every lane does the multiply and keeps it if its bit is set
+							montgomeryAvx2(x, x, x, n, inverse, limbs);
+							montgomeryAvx2(y, x, base, n, inverse, limbs);
+
+							__m256i set = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(_mm256_srli_epi64(exponent, bit), _mm256_set1_epi64x(1)));
+
+							for (size_t k = 0; k < limbs; ++k)
+								x[k] = _mm256_blendv_epi8(x[k], y[k], set);
+						}
+					}
+
+					montgomeryAvx2(x, x, one, n, inverse, limbs);
+
+					for (size_t j = 0; j < limbs; ++j)
+						storeLanes(r + j * count + i, x[j]);
+				}
+			}
+#endif
+
+			// true when the AVX2 kernels can be used
+			BIGNUMBER_INLINE bool useAvx2()
+			{
+#ifdef BIGNUMBER_BATCH_AVX2
+				static const bool retVal = Kernels::vectorBits() >= 256;
+				return retVal;
+#else
+				return false;
+#endif
+			}
+
+			// runs a kernel over some of the integers, splitting them between threads
+			// when there's enough work. work is the number of limb operations, which
+			// is compared with the number a product at the parallel threshold takes
+			BIGNUMBER_INLINE void forBlocks(size_t count, size_t work, const std::function<void(size_t, size_t)> &kernel)
+			{
+				const size_t threads = BigThreadPool::threadCount(), threshold = BigThreadPool::parallelThreshold();
+
+				if (threads <= 1 || work / threshold < threshold || count < 2 * lanes)
+				{
+					kernel(0, count);
+					return;
+				}
+
+				// two blocks for every thread so a slow one doesn't hold the rest up.
+				// the blocks are a multiple of the vector lanes
+				const size_t blocks = std::min(2 * threads, count / lanes);
+				const size_t blockSize = (count / blocks + lanes - 1) / lanes * lanes;
+				std::vector<std::function<void()>> tasks;
+
+				for (size_t first = 0; first < count; first += blockSize)
+				{
+					const size_t last = std::min(first + blockSize, count);
+					tasks.emplace_back([&kernel, first, last]() { kernel(first, last); });
+				}
+
+				BigThreadPool::run(tasks.data(), tasks.size());
+			}
+
+			// returns where the vector kernels stop in a block (the rest are done one at a time)
+			BIGNUMBER_INLINE size_t vectorEnd(size_t first, size_t last)
+			{
+#ifdef BIGNUMBER_BATCH_AVX2
+				if (useAvx2())
+					return first + (last - first) / lanes * lanes;
+#endif
+				return first;
+			}
+		} // namespace detail
+
+		using namespace detail;
+
+		BIGNUMBER_INLINE void add(limb *r, const limb *a, const limb *b, size_t limbs, size_t count)
+		{
+			forBlocks(count, count * limbs, [&](size_t first, size_t last)
+			{
+#ifdef BIGNUMBER_BATCH_AVX2
+				if (useAvx2())
+					addAvx2(r, a, b, limbs, count, first, last);
+#endif
+
+				addPortable(r, a, b, limbs, count, vectorEnd(first, last), last);
+			});
+		}
+
+		BIGNUMBER_INLINE void mul(limb *r, const limb *a, const limb *b, size_t limbs, size_t count)
+		{
+			forBlocks(count, count * limbs * limbs, [&](size_t first, size_t last)
+			{
+#ifdef BIGNUMBER_BATCH_AVX2
+				if (useAvx2())
+					mulAvx2(r, a, b, limbs, count, first, last);
+#endif
+
+				mulPortable(r, a, b, limbs, count, vectorEnd(first, last), last);
+			});
+		}
+
+		BIGNUMBER_INLINE void powMod(limb *r, const limb *a, const limb *e, const limb *n, size_t limbs, size_t count)
+		{
+			Modulus m;
+			setModulus(m, n, limbs);
+
+			// two montgomery multiplications for every bit of the exponent
+			forBlocks(count, count * limbs * limbs * limbs * 2 * limbBits, [&](size_t first, size_t last)
+			{
+#ifdef BIGNUMBER_BATCH_AVX2
+				if (useAvx2())
+					powModAvx2(r, a, e, m, limbs, count, first, last);
+#endif
+
+				powModPortable(r, a, e, m, limbs, count, vectorEnd(first, last), last);
+			});
+		}
+
+		BIGNUMBER_INLINE const char *implementation()
+		{
+			return useAvx2() ? "AVX2" : "portable";
+		}
+	} // namespace BatchKernels
+} // namespace BigNumber
@@ -0,0 +1,189 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGBATCH_H
+#define BIGBATCH_H
+
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGBATCH_H_SOURCES
+#endif
+
+#include "BigFixed.h"
+#include <cstdint>
+#include <vector>
+
+// BigBatch holds many integers with the same number of bits so the same
+// operation can be done on all of them at once. The data is stored as a
+// structure of arrays: the first limb of every integer, then the second limb
+// of every integer and so on. That way one vector instruction works on the
+// same limb of several integers (lanes) instead of several limbs of one.
+//
+// The limbs are 32 bits so the product of two of them fits in a 64-bit lane.
+// Every integer is worked out on its own and the results wrap around like
+// BigFixedUnsigned does.
+
+namespace BigNumber
+{
+	// The batch kernels work on the structure of arrays data of a BigBatch
+	// (limb j of integer i is at j * count + i). Like the other kernels they
+	// don't allocate anything and the output can be one of the inputs.
+	namespace BatchKernels
+	{
+		typedef std::uint32_t limb; // data type
+
+		/// Arithmetic over every integer (output, a, b, limbs per integer, number of integers)
+		void add(limb *, const limb *, const limb *, size_t, size_t);
+		void mul(limb *, const limb *, const limb *, size_t, size_t); // keeps the low limbs of the product
+
+		/// Modular exponentiation (output, base, exponent, modulus, limbs per integer, number of integers).
+		/// every integer uses the same modulus, which has to be odd
+		void powMod(limb *, const limb *, const limb *, const limb *, size_t, size_t);
+
+		/// Name of the kernels picked for the cpu
+		const char *implementation();
+
+		/// Largest number of limbs per integer
+		static const size_t maxLimbs = 64;
+	} // namespace BatchKernels
+
+	template <size_t Bits>
+	class BigBatch
+	{
+		static_assert(Bits > 0 && Bits % 64 == 0 && Bits / 32 <= BatchKernels::maxLimbs,
+			"BigBatch: the number of bits must be a multiple of 64 and no more than 2048");
+
+	public:
+		typedef BatchKernels::limb limb; // data type
+		typedef BigFixedUnsigned<Bits> valueType; // type of the integers
+		static constexpr size_t limbCount = Bits / 32; // number of limbs per integer
+
+		/// Constructor
+		explicit BigBatch(size_t size = 0) :count(size), limbs(size * limbCount) {}
+
+		/// Number of integers
+		size_t size() const { return count; }
+
+		/// Change the number of integers (new integers are zero)
+		void resize(size_t size)
+		{
+			BigBatch temp(size);
+
+			// the limbs have to be moved since they are grouped by position
+			for (size_t j = 0; j < limbCount; ++j)
+			{
+				for (size_t i = 0; i < size && i < count; ++i)
+					temp.limbs[j * size + i] = limbs[j * count + i];
+			}
+
+			*this = std::move(temp);
+		}
+
+		/// Get and set one of the integers
+		valueType get(size_t index) const
+		{
+			valueType retVal;
+
+			for (size_t j = 0; j < limbCount; j += 2)
+				retVal.limbs[j / 2] = (std::uint64_t)limbs[(j + 1) * count + index] << 32 | limbs[j * count + index];
+
+			return retVal;
+		}
+
+		void set(size_t index, const valueType &value)
+		{
+			for (size_t j = 0; j < limbCount; j += 2)
+			{
+				limbs[j * count + index] = (limb)value.limbs[j / 2];
+				limbs[(j + 1) * count + index] = (limb)(value.limbs[j / 2] >> 32);
+			}
+		}
+
+		/// Access to the data (limb j of integer i is at data()[j * size() + i])
+		limb *data() { return limbs.data(); }
+		const limb *data() const { return limbs.data(); }
+
+	private:
+		size_t count; // number of integers
+		std::vector<limb> limbs; // the data
+	};
+
+	/// Definition of the static member
+	template <size_t Bits> constexpr size_t BigBatch<Bits>::limbCount;
+
+	/// Batch arithmetic (out[i] = a[i] + b[i] and out[i] = a[i] * b[i])
+	template <size_t Bits>
+	void addBatch(BigBatch<Bits> &out, const BigBatch<Bits> &a, const BigBatch<Bits> &b)
+	{
+		if (a.size() != b.size())
+			throw std::invalid_argument("BigBatch: batches must be the same size");
+
+		if (out.size() != a.size())
+			out = BigBatch<Bits>(a.size());
+
+		BatchKernels::add(out.data(), a.data(), b.data(), BigBatch<Bits>::limbCount, a.size());
+	}
+
+	template <size_t Bits>
+	void mulBatch(BigBatch<Bits> &out, const BigBatch<Bits> &a, const BigBatch<Bits> &b)
+	{
+		if (a.size() != b.size())
+			throw std::invalid_argument("BigBatch: batches must be the same size");
+
+		if (out.size() != a.size())
+			out = BigBatch<Bits>(a.size());
+
+		BatchKernels::mul(out.data(), a.data(), b.data(), BigBatch<Bits>::limbCount, a.size());
+	}
+
+	/// Batch modular exponentiation (out[i] = base[i] ^ exponent[i] % modulus)
+	template <size_t Bits>
+	void powModBatch(BigBatch<Bits> &out, const BigBatch<Bits> &base, const BigBatch<Bits> &exponent, const BigFixedUnsigned<Bits> &modulus)
+	{
+		if (base.size() != exponent.size())
+			throw std::invalid_argument("BigBatch: batches must be the same size");
+
+		if ((modulus.item(0) & 1) == 0)
+			throw std::invalid_argument("BigBatch: the modulus must be odd");
+
+		if (out.size() != base.size())
+			out = BigBatch<Bits>(base.size());
+
+		// the modulus is the same for every integer so it's just the limbs
+		BatchKernels::limb limbs[BigBatch<Bits>::limbCount];
+
+		for (size_t j = 0; j < BigBatch<Bits>::limbCount; ++j)
+			limbs[j] = (BatchKernels::limb)(modulus.item(j / 2) >> (32 * (j % 2)));
+
+		BatchKernels::powMod(out.data(), base.data(), exponent.data(), limbs, BigBatch<Bits>::limbCount, base.size());
+	}
+} // namespace BigNumber
+
+#ifdef BIGBATCH_H_SOURCES
+#include "BigSources.h"
+#endif
+
+#endif // BIGBATCH_H
@@ -0,0 +1,43 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGCONFIG_H
+#define BIGCONFIG_H
+
+// Defining BIGNUMBER_HEADER_ONLY (for everything that includes the library)
+// makes the headers include the sources, so the whole library is compiled into
+// each translation unit and the compiler can inline calls into it. It needs
+// C++17. The functions defined in the sources are marked BIGNUMBER_INLINE so
+// every translation unit can have its own copy. The helpers they use are in
+// namespaces called detail instead of anonymous ones, and the helper functions
+// and variables are BIGNUMBER_INLINE too, so every copy uses the same helpers
+// (and the same variables, like the kernels picked for the cpu).
+#ifdef BIGNUMBER_HEADER_ONLY
+#define BIGNUMBER_INLINE inline
+#else
+#define BIGNUMBER_INLINE
+#endif
+
+#endif // BIGCONFIG_H
@@ -0,0 +1,133 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGDATAPTR_H
+#define BIGDATAPTR_H
+
+#include <cstddef>
+#include <utility>
+
+namespace BigNumber
+{
+	// BigDataPtr is a reference counted pointer like std::shared_ptr except
+	// the count is kept next to the data and isn't atomic. It is used instead
+	// of std::shared_ptr when the library is built with BIGNUMBER_SINGLE_THREADED
+	// or BIGNUMBER_VALUE_SEMANTICS, so it only has what BigUnsigned needs.
+	//
+	// Copies of a BigDataPtr must never be used from more than one thread.
+	template <typename T>
+	class BigDataPtr
+	{
+	public:
+		/// Constructor
+		BigDataPtr() = default;
+		BigDataPtr(std::nullptr_t) {}
+
+		/// Copy constructor
+		BigDataPtr(const BigDataPtr &rhs) :pNode(rhs.pNode)
+		{
+			if (pNode)
+				++pNode->count;
+		}
+
+		/// Move constructor
+		BigDataPtr(BigDataPtr &&rhs) :pNode(rhs.pNode) { rhs.pNode = nullptr; }
+
+		/// Destructor
+		~BigDataPtr() { reset(); }
+
+		/// Assignment operators
+		BigDataPtr &operator =(const BigDataPtr &rhs)
+		{
+			// add to the count first so assigning to itself is safe
+			if (rhs.pNode)
+				++rhs.pNode->count;
+
+			reset();
+			pNode = rhs.pNode;
+			return *this;
+		}
+
+		BigDataPtr &operator =(BigDataPtr &&rhs)
+		{
+			if (this != &rhs)
+			{
+				reset();
+				pNode = rhs.pNode;
+				rhs.pNode = nullptr;
+			}
+
+			return *this;
+		}
+
+		/// Make a new object with the count set to one
+		template <typename... Args>
+		static BigDataPtr make(Args &&... args)
+		{
+			BigDataPtr retVal;
+			retVal.pNode = new Node(std::forward<Args>(args)...);
+			return retVal;
+		}
+
+		/// Stop pointing to the object and delete it if this was the last pointer
+		void reset()
+		{
+			if (pNode && --pNode->count == 0)
+				delete pNode;
+
+			pNode = nullptr;
+		}
+
+		/// Number of pointers to the object (zero when this is nullptr)
+		long use_count() const { return pNode ? (long)pNode->count : 0; }
+
+		/// Access to the object
+		T *get() const { return pNode ? &pNode->value : nullptr; }
+		T &operator *() const { return pNode->value; }
+		T *operator ->() const { return &pNode->value; }
+
+		/// Conversion operator to bool
+		explicit operator bool() const { return pNode != nullptr; }
+
+		/// Comparison operators
+		bool operator ==(const BigDataPtr &rhs) const { return pNode == rhs.pNode; }
+		bool operator !=(const BigDataPtr &rhs) const { return pNode != rhs.pNode; }
+
+	private:
+		// the object and its count in one allocation
+		struct Node
+		{
+			template <typename... Args>
+			Node(Args &&... args) :value(std::forward<Args>(args)...) {}
+
+			T value;
+			size_t count = 1;
+		};
+
+		Node *pNode = nullptr; // pointer to the object and count
+	};
+} // namespace BigNumber
+
+#endif // BIGDATAPTR_H
@@ -0,0 +1,345 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGEXPRESSION_H
+#define BIGEXPRESSION_H
+
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGEXPRESSION_H_SOURCES
+#endif
+
+#include "BigInteger.h"
+#include <type_traits>
+
+// This is an opt-in layer that puts off arithmetic until the results are
+// assigned. Wrapping a value with lazy() makes +, - and * build a tree of
+// the expression instead of making a new value for every step:
+//
+//     assign(out, lazy(a) * b + lazy(c) * d - e);
+//
+// runs mul(out, a, b), addmul(out, c, d) and sub(out, out, e), so the whole
+// expression is worked out in out's buffer without any temporaries. Only
+// operands that are expressions themselves (like the sum in (a + b) * c) get
+// a temporary, and its buffer comes from BigUnsignedPool.
+//
+// The tree keeps references to the values, so it has to be used before any of
+// them are destroyed (normally in the same statement it's made in).
+
+namespace BigNumber
+{
+	namespace Expression
+	{
+		/// Nodes of the expression tree
+		template <typename T>
+		class Terminal
+		{
+		public:
+			typedef T valueType;
+
+			explicit Terminal(const T &value) :value(value) {}
+
+			bool refersTo(const T *other) const { return &value == other; }
+
+			const T &value;
+		};
+
+		template <typename L, typename R>
+		class Sum
+		{
+		public:
+			typedef typename L::valueType valueType;
+
+			Sum(const L &left, const R &right) :left(left), right(right) {}
+
+			bool refersTo(const valueType *other) const { return left.refersTo(other) || right.refersTo(other); }
+
+			L left;
+			R right;
+		};
+
+		template <typename L, typename R>
+		class Difference
+		{
+		public:
+			typedef typename L::valueType valueType;
+
+			Difference(const L &left, const R &right) :left(left), right(right) {}
+
+			bool refersTo(const valueType *other) const { return left.refersTo(other) || right.refersTo(other); }
+
+			L left;
+			R right;
+		};
+
+		template <typename L, typename R>
+		class Product
+		{
+		public:
+			typedef typename L::valueType valueType;
+
+			Product(const L &left, const R &right) :left(left), right(right) {}
+
+			bool refersTo(const valueType *other) const { return left.refersTo(other) || right.refersTo(other); }
+
+			L left;
+			R right;
+		};
+
+		/// Type traits for the nodes
+		template <typename T> struct IsNode : std::false_type {};
+		template <typename T> struct IsNode<Terminal<T>> : std::true_type {};
+		template <typename L, typename R> struct IsNode<Sum<L, R>> : std::true_type {};
+		template <typename L, typename R> struct IsNode<Difference<L, R>> : std::true_type {};
+		template <typename L, typename R> struct IsNode<Product<L, R>> : std::true_type {};
+
+		template <typename T> struct IsValue : std::integral_constant<bool, std::is_same<T, BigUnsigned>::value || std::is_same<T, BigInteger>::value> {};
+
+		// ToNode turns a value into a terminal and leaves nodes the way they are
+		template <typename T, bool = IsNode<T>::value>
+		struct ToNode
+		{
+			typedef T type;
+			static const T &make(const T &node) { return node; }
+		};
+
+		template <typename T>
+		struct ToNode<T, false>
+		{
+			typedef Terminal<T> type;
+			static Terminal<T> make(const T &value) { return Terminal<T>(value); }
+		};
+
+		// template alias for the operators. they need at least one node and the other
+		// side has to be a node or a value, and both sides need the same value type
+		template <typename L, typename R>
+		using EnableIfOperands = typename std::enable_if<
+			(IsNode<L>::value || IsNode<R>::value) &&
+			(IsNode<L>::value || IsValue<L>::value) &&
+			(IsNode<R>::value || IsValue<R>::value) &&
+			std::is_same<typename ToNode<L>::type::valueType, typename ToNode<R>::type::valueType>::value, int>::type;
+
+		/// Operators that build the tree
+		template <typename L, typename R, EnableIfOperands<L, R> = 0>
+		Sum<typename ToNode<L>::type, typename ToNode<R>::type> operator +(const L &lhs, const R &rhs)
+		{
+			return Sum<typename ToNode<L>::type, typename ToNode<R>::type>(ToNode<L>::make(lhs), ToNode<R>::make(rhs));
+		}
+
+		template <typename L, typename R, EnableIfOperands<L, R> = 0>
+		Difference<typename ToNode<L>::type, typename ToNode<R>::type> operator -(const L &lhs, const R &rhs)
+		{
+			return Difference<typename ToNode<L>::type, typename ToNode<R>::type>(ToNode<L>::make(lhs), ToNode<R>::make(rhs));
+		}
+
+		template <typename L, typename R, EnableIfOperands<L, R> = 0>
+		Product<typename ToNode<L>::type, typename ToNode<R>::type> operator *(const L &lhs, const R &rhs)
+		{
+			return Product<typename ToNode<L>::type, typename ToNode<R>::type>(ToNode<L>::make(lhs), ToNode<R>::make(rhs));
+		}
+
+		/// Required declarations of the evaluation functions
+		template <typename T> void evaluateInto(T &, const Terminal<T> &);
+		template <typename T, typename L, typename R> void evaluateInto(T &, const Sum<L, R> &);
+		template <typename T, typename L, typename R> void evaluateInto(T &, const Difference<L, R> &);
+		template <typename T, typename L, typename R> void evaluateInto(T &, const Product<L, R> &);
+		template <typename T> void accumulate(T &, const Terminal<T> &, bool);
+		template <typename T, typename L, typename R> void accumulate(T &, const Sum<L, R> &, bool);
+		template <typename T, typename L, typename R> void accumulate(T &, const Difference<L, R> &, bool);
+		template <typename T, typename L, typename R> void accumulate(T &, const Product<L, R> &, bool);
+
+		// Operand gives a reference to the value of a node. terminals are used
+		// directly and everything else is worked out into a temporary
+		template <typename E>
+		class Operand
+		{
+		public:
+			explicit Operand(const E &node) { evaluateInto(value, node); }
+			const typename E::valueType &get() const { return value; }
+
+		private:
+			typename E::valueType value;
+		};
+
+		template <typename T>
+		class Operand<Terminal<T>>
+		{
+		public:
+			explicit Operand(const Terminal<T> &node) :value(node.value) {}
+			const T &get() const { return value; }
+
+		private:
+			const T &value;
+		};
+
+		// evaluateInto sets out to the value of the node. out can't be used in the node
+		template <typename T>
+		void evaluateInto(T &out, const Terminal<T> &node)
+		{
+			out = node.value;
+		}
+
+		template <typename T, typename L, typename R>
+		void evaluateInto(T &out, const Sum<L, R> &node)
+		{
+			evaluateInto(out, node.left);
+			accumulate(out, node.right, true);
+		}
+
+		template <typename T, typename L, typename R>
+		void evaluateInto(T &out, const Difference<L, R> &node)
+		{
+			evaluateInto(out, node.left);
+			accumulate(out, node.right, false);
+		}
+
+		template <typename T, typename L, typename R>
+		void evaluateInto(T &out, const Product<L, R> &node)
+		{
+			Operand<L> left(node.left);
+			Operand<R> right(node.right);
+			BigNumber::mul(out, left.get(), right.get());
+		}
+
+		// accumulate adds the value of the node to out (or subtracts it if add is false).
+		// products are fused into addmul and submul. out can't be used in the node
+		template <typename T>
+		void accumulate(T &out, const Terminal<T> &node, bool add)
+		{
+			if (add)
+				BigNumber::add(out, out, node.value);
+			else
+				BigNumber::sub(out, out, node.value);
+		}
+
+		template <typename T, typename L, typename R>
+		void accumulate(T &out, const Sum<L, R> &node, bool add)
+		{
+			accumulate(out, node.left, add);
+			accumulate(out, node.right, add);
+		}
+
+		template <typename T, typename L, typename R>
+		void accumulate(T &out, const Difference<L, R> &node, bool add)
+		{
+			// the part that gets added goes first so an unsigned value
+			// doesn't go below zero part way through
+			if (add)
+			{
+				accumulate(out, node.left, true);
+				accumulate(out, node.right, false);
+			}
+			else
+			{
+				accumulate(out, node.right, true);
+				accumulate(out, node.left, false);
+			}
+		}
+
+		template <typename T, typename L, typename R>
+		void accumulate(T &out, const Product<L, R> &node, bool add)
+		{
+			Operand<L> left(node.left);
+			Operand<R> right(node.right);
+
+			if (add)
+				BigNumber::addmul(out, left.get(), right.get());
+			else
+				BigNumber::submul(out, left.get(), right.get());
+		}
+
+		// template alias for the functions that take a whole expression
+		template <typename T, typename E>
+		using EnableIfExpression = typename std::enable_if<IsNode<E>::value && std::is_same<T, typename E::valueType>::value, int>::type;
+	} // namespace Expression
+
+	/// Start an expression with a value
+	template <typename T, typename std::enable_if<Expression::IsValue<T>::value, int>::type = 0>
+	Expression::Terminal<T> lazy(const T &value)
+	{
+		return Expression::Terminal<T>(value);
+	}
+
+	/// Set out to the value of an expression (out = expression)
+	template <typename T, typename E, Expression::EnableIfExpression<T, E> = 0>
+	void assign(T &out, const E &expression)
+	{
+		if (expression.refersTo(&out))
+		{
+			// out is used in the expression so it can't be changed until the end
+			T results;
+			Expression::evaluateInto(results, expression);
+			out = std::move(results);
+		}
+		else
+			Expression::evaluateInto(out, expression);
+	}
+
+	/// Add the value of an expression to out (out += expression)
+	template <typename T, typename E, Expression::EnableIfExpression<T, E> = 0>
+	void addTo(T &out, const E &expression)
+	{
+		if (expression.refersTo(&out))
+		{
+			// out is used in the expression so work it out first
+			T results;
+			Expression::evaluateInto(results, expression);
+			out += results;
+		}
+		else
+			Expression::accumulate(out, expression, true);
+	}
+
+	/// Subtract the value of an expression from out (out -= expression)
+	template <typename T, typename E, Expression::EnableIfExpression<T, E> = 0>
+	void subtractFrom(T &out, const E &expression)
+	{
+		if (expression.refersTo(&out))
+		{
+			// out is used in the expression so work it out first
+			T results;
+			Expression::evaluateInto(results, expression);
+			out -= results;
+		}
+		else
+			Expression::accumulate(out, expression, false);
+	}
+
+	/// Get the value of an expression
+	template <typename E, typename std::enable_if<Expression::IsNode<E>::value, int>::type = 0>
+	typename E::valueType evaluate(const E &expression)
+	{
+		typename E::valueType retVal;
+		Expression::evaluateInto(retVal, expression);
+		return retVal;
+	}
+} // namespace BigNumber
+
+#ifdef BIGEXPRESSION_H_SOURCES
+#include "BigSources.h"
+#endif
+
+#endif // BIGEXPRESSION_H
@@ -0,0 +1,1005 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGFIXED_H
+#define BIGFIXED_H
+
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGFIXED_H_SOURCES
+#endif
+
+#include "BigIntegerUtil.h"
+#include <cstdint>
+
+// BigFixed is an integer with a number of bits picked at compile time. The data
+// is kept in an array inside the object (no heap, no leading zeros to remove)
+// and every operation is constexpr, so it works for values that are known to
+// fit in 128, 256, 512 or 1024 bits. Negative values of the signed version are
+// stored in two's complement just like the built-in types.
+//
+// OverflowMode::Wrap makes results wrap around like unsigned built-in types do
+// (this is the default) and OverflowMode::Throw makes any result that doesn't
+// fit throw an overflow_error instead. In a constant expression the throw turns
+// into a compile error.
+//
+// This header needs C++14 or better (constexpr functions with loops).
+
+namespace BigNumber
+{
+	/// What BigFixed does when the results don't fit
+	enum class OverflowMode { Wrap, Throw };
+
+	/// Required declarations of classes
+	template <size_t> class BigBatch;
+
+	template <size_t Bits, bool Signed = false, OverflowMode Mode = OverflowMode::Wrap>
+	class BigFixed
+	{
+		static_assert(Bits > 0 && Bits % 64 == 0, "BigFixed: the number of bits must be a multiple of 64");
+
+	public:
+		typedef std::uint64_t limb; // data type
+		static constexpr size_t limbBits = 64; // number of bits in the data type
+		static constexpr size_t limbCount = Bits / limbBits; // number of items in the data
+
+		/// Constructor
+		constexpr BigFixed() :limbs{} {}
+
+		/// Construct from integral type
+		template <typename T, EnableIfIntegral<T> = 0>
+		constexpr BigFixed(T value) :limbs{}
+		{
+			const bool negative = value < T(0);
+			const limb fill = negative ? ~(limb)0 : 0;
+
+			if (!Signed && negative)
+				overflow("BigFixed: Cannot set an unsigned value from a negative number");
+
+			// copy the value one item at a time, filling the rest with the sign
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				if (i * limbBits < 8 * sizeof(T))
+				{
+					limbs[i] = (limb)value;
+					value = shiftDown(value);
+				}
+				else
+					limbs[i] = fill;
+			}
+
+			// whatever is left has to be just the sign or it didn't fit
+			if (8 * sizeof(T) > Bits && (limb)value != fill)
+				overflow("BigFixed: Value is too big to fit in the requested type");
+
+			if (Signed && isNegative() != negative)
+				overflow("BigFixed: Value is too big to fit in the requested type");
+		}
+
+		/// Construct from a BigUnsigned or BigInteger (the low bits are used when it doesn't fit)
+		explicit BigFixed(const BigUnsigned &);
+		explicit BigFixed(const BigInteger &);
+
+		/// Construct from a BigFixed of a different size or type
+		template <size_t OtherBits, bool OtherSigned, OverflowMode OtherMode>
+		constexpr explicit BigFixed(const BigFixed<OtherBits, OtherSigned, OtherMode> &other) :limbs{}
+		{
+			for (size_t i = 0; i < limbCount; ++i)
+				limbs[i] = other.item(i); // item() extends the sign past the end
+
+			if (!Signed && other.isNegative())
+				overflow("BigFixed: Cannot set an unsigned value from a negative number");
+
+			// the items that got cut off have to be just the sign or it didn't fit
+			for (size_t i = limbCount; i < other.limbCount; ++i)
+			{
+				if (other.item(i) != item(i))
+					overflow("BigFixed: Value is too big to fit in the requested type");
+			}
+
+			if (Signed && isNegative() != other.isNegative())
+				overflow("BigFixed: Value is too big to fit in the requested type");
+		}
+
+		/// Conversion from a string (works in a constant expression)
+		//
+		// A base of 0 picks the base from the prefix like an integer literal does
+		// (0x for 16, 0b for 2, 0 for 8 and 10 otherwise). Digit separators (')
+		// are skipped.
+		static constexpr BigFixed fromString(const char *str, unsigned int base = 10)
+		{
+			if (base == 1 || base > 36)
+				throw std::out_of_range("BigFixed::fromString: invalid base number");
+
+			bool negative = false;
+
+			if (*str == '-' || *str == '+')
+				negative = *str++ == '-';
+
+			// skip the prefix if the base allows it
+			if (str[0] == '0' && str[1] != '\0')
+			{
+				if ((str[1] == 'x' || str[1] == 'X') && (base == 0 || base == 16))
+				{
+					base = 16;
+					str += 2;
+				}
+				else if ((str[1] == 'b' || str[1] == 'B') && (base == 0 || base == 2))
+				{
+					base = 2;
+					str += 2;
+				}
+				else if (base == 0)
+				{
+					base = 8;
+					++str;
+				}
+			}
+
+			if (base == 0)
+				base = 10;
+
+			if (*str == '\0')
+				throw std::runtime_error("BigFixed::fromString: string received is not a valid number");
+
+			BigFixed<Bits, false, Mode> magnitude;
+
+			for (; *str != '\0'; ++str)
+			{
+				if (*str == '\'')
+					continue;
+
+				const unsigned int digit = digitValue(*str);
+
+				if (digit >= base)
+					throw std::runtime_error("BigFixed::fromString: invalid character found for specified base");
+
+				if (magnitude.mulAdd(base, digit) != 0)
+					overflow("BigFixed: Value is too big to fit in the requested type");
+			}
+
+			return fromMagnitude(magnitude, negative);
+		}
+
+		/// Conversion operators
+		constexpr explicit operator bool() const
+		{
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				if (limbs[i] != 0)
+					return true;
+			}
+
+			return false;
+		}
+
+		template <typename T, EnableIfIntegral<T> = 0>
+		constexpr explicit operator T() const
+		{
+			T retVal = 0;
+
+			// put the items together from the top down
+			for (size_t i = (8 * sizeof(T) + limbBits - 1) / limbBits; i-- > 0;)
+			{
+				retVal = shiftUp(retVal);
+				retVal |= (T)item(i);
+			}
+
+			// converting back has to give the same value or it didn't fit
+			if (Mode == OverflowMode::Throw && BigFixed(retVal) != *this)
+				throw std::overflow_error("BigFixed: Value is too big to fit in the requested type");
+
+			return retVal;
+		}
+
+		explicit operator BigUnsigned() const;
+		explicit operator BigInteger() const;
+
+		/// Compound assignment operators
+		constexpr BigFixed &operator +=(const BigFixed &rhs)
+		{
+			const bool lhsNegative = isNegative();
+			limb carry = 0;
+
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				const limb sum = limbs[i] + rhs.limbs[i];
+				const limb carryOut = sum < rhs.limbs[i] ? 1 : 0;
+				limbs[i] = sum + carry;
+				carry = carryOut + (limbs[i] < carry ? 1 : 0);
+			}
+
+			checkAddition(carry != 0, lhsNegative, rhs.isNegative());
+			return *this;
+		}
+
+		constexpr BigFixed &operator -=(const BigFixed &rhs)
+		{
+			const bool lhsNegative = isNegative();
+			limb borrow = 0;
+
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				const limb value = limbs[i];
+				const limb difference = value - rhs.limbs[i];
+				const limb borrowOut = (value < rhs.limbs[i] ? 1 : 0) + (difference < borrow ? 1 : 0);
+				limbs[i] = difference - borrow;
+				borrow = borrowOut;
+			}
+
+			checkAddition(borrow != 0, lhsNegative, !rhs.isNegative());
+			return *this;
+		}
+
+		constexpr BigFixed &operator *=(const BigFixed &rhs)
+		{
+			// multiply the magnitudes so the overflow check works for both
+			// signed and unsigned values, then put the sign back on
+			const bool negative = isNegative() != rhs.isNegative();
+			const UnsignedType a = magnitude(), b = rhs.magnitude();
+
+			BigFixed results;
+			bool overflowed = false;
+
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				limb carry = 0;
+
+				if (a.limbs[i] == 0)
+					continue;
+
+				// wrapping doesn't need the part of the product that doesn't fit
+				const size_t size = Mode == OverflowMode::Throw ? limbCount : limbCount - i;
+
+				for (size_t j = 0; j < size; ++j)
+				{
+					limb high = 0;
+					limb low = mulWide(a.limbs[i], b.limbs[j], high);
+
+					low += carry;
+					high += low < carry ? 1 : 0;
+
+					if (i + j < limbCount)
+					{
+						results.limbs[i + j] += low;
+						high += results.limbs[i + j] < low ? 1 : 0;
+					}
+					else if (low != 0)
+						overflowed = true; // this part of the product doesn't fit
+
+					carry = high;
+				}
+
+				if (carry != 0)
+					overflowed = true;
+			}
+
+			*this = negative ? sameBits(-results.asWrapping()) : results;
+
+			// the magnitude has to fit in the bits that aren't the sign
+			if (Mode == OverflowMode::Throw)
+			{
+				if (overflowed || (Signed && results.isNegative() && !(negative && results.isMinimum())))
+					throw std::overflow_error("BigFixed: Value is too big to fit in the requested type");
+			}
+
+			return *this;
+		}
+
+		constexpr BigFixed &operator /=(const BigFixed &rhs)
+		{
+			BigFixed remainder;
+			*this = divide(*this, rhs, remainder);
+			return *this;
+		}
+
+		constexpr BigFixed &operator %=(const BigFixed &rhs)
+		{
+			divide(*this, rhs, *this);
+			return *this;
+		}
+
+		constexpr BigFixed &operator &=(const BigFixed &rhs)
+		{
+			for (size_t i = 0; i < limbCount; ++i)
+				limbs[i] &= rhs.limbs[i];
+
+			return *this;
+		}
+
+		constexpr BigFixed &operator |=(const BigFixed &rhs)
+		{
+			for (size_t i = 0; i < limbCount; ++i)
+				limbs[i] |= rhs.limbs[i];
+
+			return *this;
+		}
+
+		constexpr BigFixed &operator ^=(const BigFixed &rhs)
+		{
+			for (size_t i = 0; i < limbCount; ++i)
+				limbs[i] ^= rhs.limbs[i];
+
+			return *this;
+		}
+
+		constexpr BigFixed &operator <<=(size_t amount)
+		{
+			const BigFixed before = *this;
+			const size_t numOfItems = amount / limbBits;
+			const unsigned int numOfBits = (unsigned int)(amount % limbBits);
+
+			// move the data up starting from the top
+			for (size_t i = limbCount; i-- > 0;)
+			{
+				limb value = 0;
+
+				if (i >= numOfItems)
+				{
+					value = limbs[i - numOfItems] << numOfBits;
+
+					if (numOfBits != 0 && i > numOfItems)
+						value |= limbs[i - numOfItems - 1] >> (limbBits - numOfBits);
+				}
+
+				limbs[i] = value;
+			}
+
+			// shifting back has to give the same value or bits were lost
+			if (Mode == OverflowMode::Throw && (amount >= Bits ? (bool)before : (*this >> amount) != before))
+				throw std::overflow_error("BigFixed: Value is too big to fit in the requested type");
+
+			return *this;
+		}
+
+		constexpr BigFixed &operator >>=(size_t amount)
+		{
+			// signed values shift in copies of the sign bit
+			const limb fill = isNegative() ? ~(limb)0 : 0;
+			const size_t numOfItems = amount / limbBits;
+			const unsigned int numOfBits = (unsigned int)(amount % limbBits);
+
+			// move the data down starting from the bottom
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				limb value = fill;
+
+				if (i + numOfItems < limbCount)
+				{
+					const limb next = i + numOfItems + 1 < limbCount ? limbs[i + numOfItems + 1] : fill;
+					value = limbs[i + numOfItems] >> numOfBits;
+
+					if (numOfBits != 0)
+						value |= next << (limbBits - numOfBits);
+				}
+
+				limbs[i] = value;
+			}
+
+			return *this;
+		}
+
+		/// Bitwise NOT
+		constexpr BigFixed operator ~() const
+		{
+			BigFixed retVal;
+
+			for (size_t i = 0; i < limbCount; ++i)
+				retVal.limbs[i] = ~limbs[i];
+
+			return retVal;
+		}
+
+		/// Unary minus
+		constexpr BigFixed operator -() const
+		{
+			// zero is the only unsigned value that can be negated and the
+			// smallest signed value has no positive version
+			if (Mode == OverflowMode::Throw && (Signed ? isMinimum() : (bool)*this))
+				throw std::overflow_error("BigFixed: Value is too big to fit in the requested type");
+
+			BigFixed retVal = ~*this;
+			retVal.addOne();
+			return retVal;
+		}
+
+		/// Prefix increment and decrement
+		constexpr BigFixed &operator ++() { return *this += BigFixed(1); }
+		constexpr BigFixed &operator --() { return *this -= BigFixed(1); }
+
+		/// Postfix increment and decrement
+		constexpr BigFixed operator ++(int)
+		{
+			BigFixed temp(*this);
+			++*this;
+			return temp;
+		}
+
+		constexpr BigFixed operator --(int)
+		{
+			BigFixed temp(*this);
+			--*this;
+			return temp;
+		}
+
+		/// Comparison of two values (returns -1, 0 or 1)
+		static constexpr int compare(const BigFixed &lhs, const BigFixed &rhs)
+		{
+			// a negative value is smaller than any value that isn't negative
+			if (lhs.isNegative() != rhs.isNegative())
+				return lhs.isNegative() ? -1 : 1;
+
+			for (size_t i = limbCount; i-- > 0;)
+			{
+				if (lhs.limbs[i] != rhs.limbs[i])
+					return lhs.limbs[i] < rhs.limbs[i] ? -1 : 1;
+			}
+
+			return 0;
+		}
+
+		/// Get an item of the data (least significant item first)
+		constexpr limb item(size_t index) const
+		{
+			if (index < limbCount)
+				return limbs[index];
+			else
+				return isNegative() ? ~(limb)0 : 0; // the sign goes on forever
+		}
+
+		/// Check if the value is negative
+		constexpr bool isNegative() const
+		{
+			return Signed && (limbs[limbCount - 1] >> (limbBits - 1)) != 0;
+		}
+
+		/// Division that also gives the remainder
+		static constexpr BigFixed divide(const BigFixed &lhs, const BigFixed &rhs, BigFixed &remainder)
+		{
+			if (!rhs)
+				throw std::invalid_argument("BigFixed: cannot divide by zero");
+
+			// divide the magnitudes, then the quotient is negative when the
+			// signs are different and the remainder has lhs's sign
+			const bool negative = lhs.isNegative() != rhs.isNegative(), lhsNegative = lhs.isNegative();
+			const UnsignedType a = lhs.magnitude(), b = rhs.magnitude();
+
+			UnsignedType quotient, rest;
+
+			if (b.fitsInHalfLimb())
+			{
+				// a small divisor can be done half a limb at a time
+				const limb divisor = b.limbs[0];
+				limb current = 0;
+
+				for (size_t i = limbCount; i-- > 0;)
+				{
+					current = (current << 32) | (a.limbs[i] >> 32);
+					limb high = current / divisor;
+					current %= divisor;
+
+					current = (current << 32) | (a.limbs[i] & 0xFFFFFFFF);
+					quotient.limbs[i] = (high << 32) | (current / divisor);
+					current %= divisor;
+				}
+
+				rest.limbs[0] = current;
+			}
+			else
+			{
+				// shift and subtract one bit at a time
+				for (size_t i = a.bitLength(); i-- > 0;)
+				{
+					const bool carry = (rest.limbs[limbCount - 1] >> (limbBits - 1)) != 0;
+
+					rest.shiftLeftOne();
+					rest.limbs[0] |= (a.limbs[i / limbBits] >> (i % limbBits)) & 1;
+
+					if (carry || !rest.lessUnsigned(b))
+					{
+						rest.subtractWrapping(b);
+						quotient.limbs[i / limbBits] |= (limb)1 << (i % limbBits);
+					}
+				}
+			}
+
+			const BigFixed q = sameBits(quotient), r = sameBits(rest);
+
+			// the smallest signed value divided by -1 doesn't fit
+			if (Mode == OverflowMode::Throw && !negative && q.isNegative())
+				throw std::overflow_error("BigFixed: Value is too big to fit in the requested type");
+
+			remainder = lhsNegative ? sameBits(-r.asWrapping()) : r;
+			return negative ? sameBits(-q.asWrapping()) : q;
+		}
+
+	private:
+		template <size_t, bool, OverflowMode> friend class BigFixed;
+		template <size_t> friend class BigBatch;
+
+		typedef BigFixed<Bits, false, OverflowMode::Wrap> UnsignedType; // type used for the magnitudes
+
+		limb limbs[limbCount]; // the data (least significant item first)
+
+		// overflow throws an overflow_error in Throw mode and does nothing in Wrap mode
+		static constexpr void overflow(const char *message)
+		{
+			if (Mode == OverflowMode::Throw)
+				throw std::overflow_error(message);
+		}
+
+		// checkAddition checks the results of += or -=. carry is the carry (or borrow) out
+		// of the top. signed results overflow when both values added had the same sign
+		// and the results have a different one (subtracting flips the sign of rhs)
+		constexpr void checkAddition(bool carry, bool lhsNegative, bool rhsNegative) const
+		{
+			if (Signed ? (lhsNegative == rhsNegative && isNegative() != lhsNegative) : carry)
+				overflow("BigFixed: Value is too big to fit in the requested type");
+		}
+
+		// returns value shifted down by one item (zero or the sign when it's not wider than an item)
+		template <typename T>
+		static constexpr T shiftDown(T value)
+		{
+			return 8 * sizeof(T) > limbBits ? (T)(value >> (8 * sizeof(T) > limbBits ? limbBits : 0)) : T(value < T(0) ? -1 : 0);
+		}
+
+		// returns value shifted up by one item (zero when it's not wider than an item)
+		template <typename T>
+		static constexpr T shiftUp(T value)
+		{
+			return 8 * sizeof(T) > limbBits ? (T)(value << (8 * sizeof(T) > limbBits ? limbBits : 0)) : T(0);
+		}
+
+		// mulWide multiplies two items by splitting them into halves (returns the low item and sets the high item)
+		static constexpr limb mulWide(limb a, limb b, limb &high)
+		{
+			const limb aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+			const limb bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+
+			const limb lowLow = aLow * bLow, lowHigh = aLow * bHigh;
+			const limb highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+			const limb middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFF) + (highLow & 0xFFFFFFFF);
+
+			high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+			return (middle << 32) | (lowLow & 0xFFFFFFFF);
+		}
+
+		// returns the same bits with wrapping so negating it can't throw
+		constexpr BigFixed<Bits, Signed, OverflowMode::Wrap> asWrapping() const
+		{
+			BigFixed<Bits, Signed, OverflowMode::Wrap> retVal;
+
+			for (size_t i = 0; i < limbCount; ++i)
+				retVal.limbs[i] = limbs[i];
+
+			return retVal;
+		}
+
+		// sameBits gives a value with the same bits as a BigFixed of any type with the same size
+		template <bool OtherSigned, OverflowMode OtherMode>
+		static constexpr BigFixed sameBits(const BigFixed<Bits, OtherSigned, OtherMode> &other)
+		{
+			BigFixed retVal;
+
+			for (size_t i = 0; i < limbCount; ++i)
+				retVal.limbs[i] = other.limbs[i];
+
+			return retVal;
+		}
+
+		// fromMagnitude gives the value with the magnitude (as unsigned bits) and sign
+		static constexpr BigFixed fromMagnitude(const BigFixed<Bits, false, Mode> &bits, bool negative)
+		{
+			BigFixed retVal = sameBits(bits);
+
+			if (negative && bits)
+			{
+				retVal = sameBits(-retVal.asWrapping());
+
+				if (!Signed)
+					overflow("BigFixed: Cannot set an unsigned value from a negative number");
+				else if (!retVal.isNegative())
+					overflow("BigFixed: Value is too big to fit in the requested type");
+			}
+			else if (retVal.isNegative())
+				overflow("BigFixed: Value is too big to fit in the requested type");
+
+			return retVal;
+		}
+
+		// returns the absolute value as unsigned bits
+		constexpr UnsignedType magnitude() const
+		{
+			return UnsignedType::sameBits(isNegative() ? -asWrapping() : asWrapping());
+		}
+
+		// checks if this is the smallest signed value (only the sign bit set)
+		constexpr bool isMinimum() const
+		{
+			for (size_t i = 0; i + 1 < limbCount; ++i)
+			{
+				if (limbs[i] != 0)
+					return false;
+			}
+
+			return limbs[limbCount - 1] == (limb)1 << (limbBits - 1);
+		}
+
+		// checks if the value is smaller than 2^32
+		constexpr bool fitsInHalfLimb() const
+		{
+			for (size_t i = 1; i < limbCount; ++i)
+			{
+				if (limbs[i] != 0)
+					return false;
+			}
+
+			return limbs[0] <= 0xFFFFFFFF;
+		}
+
+		// returns the number of bits without the leading zeros
+		constexpr size_t bitLength() const
+		{
+			for (size_t i = limbCount; i-- > 0;)
+			{
+				if (limbs[i] != 0)
+				{
+					size_t retVal = i * limbBits;
+
+					for (limb value = limbs[i]; value != 0; value >>= 1)
+						++retVal;
+
+					return retVal;
+				}
+			}
+
+			return 0;
+		}
+
+		// addOne adds one ignoring any overflow
+		constexpr void addOne()
+		{
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				if (++limbs[i] != 0)
+					break;
+			}
+		}
+
+		// mulAdd multiplies by one item and adds another ignoring any overflow (returns the item that didn't fit)
+		constexpr limb mulAdd(limb multiplier, limb addend)
+		{
+			limb carry = addend;
+
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				limb high = 0;
+				limb low = mulWide(limbs[i], multiplier, high);
+
+				low += carry;
+				limbs[i] = low;
+				carry = high + (low < carry ? 1 : 0);
+			}
+
+			return carry;
+		}
+
+		// digitValue gives the value of a digit in any base up to 36 (or 36 if it's not a digit)
+		static constexpr unsigned int digitValue(char c)
+		{
+			if (c >= '0' && c <= '9')
+				return c - '0';
+			else if (c >= 'a' && c <= 'z')
+				return c - 'a' + 10;
+			else if (c >= 'A' && c <= 'Z')
+				return c - 'A' + 10;
+			else
+				return 36;
+		}
+
+		// shiftLeftOne shifts one bit to the left ignoring any overflow
+		constexpr void shiftLeftOne()
+		{
+			for (size_t i = limbCount; i-- > 1;)
+				limbs[i] = (limbs[i] << 1) | (limbs[i - 1] >> (limbBits - 1));
+
+			limbs[0] <<= 1;
+		}
+
+		// subtractWrapping subtracts ignoring any overflow
+		constexpr void subtractWrapping(const BigFixed &rhs)
+		{
+			limb borrow = 0;
+
+			for (size_t i = 0; i < limbCount; ++i)
+			{
+				const limb value = limbs[i];
+				const limb difference = value - rhs.limbs[i];
+				const limb borrowOut = (value < rhs.limbs[i] ? 1 : 0) + (difference < borrow ? 1 : 0);
+				limbs[i] = difference - borrow;
+				borrow = borrowOut;
+			}
+		}
+
+		// lessUnsigned compares the bits as if they were unsigned
+		constexpr bool lessUnsigned(const BigFixed &rhs) const
+		{
+			for (size_t i = limbCount; i-- > 0;)
+			{
+				if (limbs[i] != rhs.limbs[i])
+					return limbs[i] < rhs.limbs[i];
+			}
+
+			return false;
+		}
+	};
+
+	/// Definitions of the static members
+	template <size_t Bits, bool Signed, OverflowMode Mode> constexpr size_t BigFixed<Bits, Signed, Mode>::limbBits;
+	template <size_t Bits, bool Signed, OverflowMode Mode> constexpr size_t BigFixed<Bits, Signed, Mode>::limbCount;
+
+	/// Aliases for the common cases
+	template <size_t Bits, OverflowMode Mode = OverflowMode::Wrap>
+	using BigFixedUnsigned = BigFixed<Bits, false, Mode>;
+
+	template <size_t Bits, OverflowMode Mode = OverflowMode::Wrap>
+	using BigFixedSigned = BigFixed<Bits, true, Mode>;
+
+	/// Construct from a BigUnsigned
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	BigFixed<Bits, Signed, Mode>::BigFixed(const BigUnsigned &value) :limbs{}
+	{
+		typedef BigUnsigned::dataType dataType;
+		const size_t dataTypeSize = BigUnsigned::dataTypeSize;
+
+		if (value) // check if not zero
+		{
+			size_t bit = 0; // the bit the current item starts at
+
+			for (const dataType &data : *value.pData)
+			{
+				if (bit >= Bits)
+				{
+					overflow("BigFixed: Value is too big to fit in the requested type");
+					break;
+				}
+
+				limbs[bit / limbBits] |= (limb)data << (bit % limbBits);
+				bit += dataTypeSize;
+			}
+
+			if (isNegative())
+				overflow("BigFixed: Value is too big to fit in the requested type");
+		}
+	}
+
+	/// Construct from a BigInteger
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	BigFixed<Bits, Signed, Mode>::BigFixed(const BigInteger &value)
+		:BigFixed(fromMagnitude(BigFixed<Bits, false, Mode>(value.data), value.negative))
+	{
+	}
+
+	/// Conversion operator to BigUnsigned
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	BigFixed<Bits, Signed, Mode>::operator BigUnsigned() const
+	{
+		typedef BigUnsigned::dataType dataType;
+		const size_t dataTypeSize = BigUnsigned::dataTypeSize;
+
+		if (isNegative())
+			throw std::runtime_error("BigFixed: cannot convert a negative number to an unsigned data type");
+
+		BigUnsigned retVal;
+		retVal.reserveData(Bits / dataTypeSize);
+
+		// copy the bits one item of BigUnsigned's data type at a time
+		for (size_t bit = 0; bit < Bits; bit += dataTypeSize)
+			retVal.pData->push_back((dataType)(limbs[bit / limbBits] >> (bit % limbBits)));
+
+		retVal.removeLeadingZeros();
+		return retVal;
+	}
+
+	/// Conversion operator to BigInteger
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	BigFixed<Bits, Signed, Mode>::operator BigInteger() const
+	{
+		BigInteger retVal;
+		retVal.data = (BigUnsigned)magnitude();
+		retVal.negative = isNegative();
+		return retVal;
+	}
+
+	/// Arithmetic operators
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator +(BigFixed<Bits, Signed, Mode> lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return lhs += rhs;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator -(BigFixed<Bits, Signed, Mode> lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return lhs -= rhs;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator *(BigFixed<Bits, Signed, Mode> lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return lhs *= rhs;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator /(BigFixed<Bits, Signed, Mode> lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return lhs /= rhs;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator %(BigFixed<Bits, Signed, Mode> lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return lhs %= rhs;
+	}
+
+	/// Bitwise operators
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator &(BigFixed<Bits, Signed, Mode> lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return lhs &= rhs;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator |(BigFixed<Bits, Signed, Mode> lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return lhs |= rhs;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator ^(BigFixed<Bits, Signed, Mode> lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return lhs ^= rhs;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator <<(BigFixed<Bits, Signed, Mode> lhs, size_t amount)
+	{
+		return lhs <<= amount;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr BigFixed<Bits, Signed, Mode> operator >>(BigFixed<Bits, Signed, Mode> lhs, size_t amount)
+	{
+		return lhs >>= amount;
+	}
+
+	/// Comparison operators
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr bool operator ==(const BigFixed<Bits, Signed, Mode> &lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return BigFixed<Bits, Signed, Mode>::compare(lhs, rhs) == 0;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr bool operator !=(const BigFixed<Bits, Signed, Mode> &lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return BigFixed<Bits, Signed, Mode>::compare(lhs, rhs) != 0;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr bool operator <(const BigFixed<Bits, Signed, Mode> &lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return BigFixed<Bits, Signed, Mode>::compare(lhs, rhs) < 0;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr bool operator >(const BigFixed<Bits, Signed, Mode> &lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return BigFixed<Bits, Signed, Mode>::compare(lhs, rhs) > 0;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr bool operator <=(const BigFixed<Bits, Signed, Mode> &lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return BigFixed<Bits, Signed, Mode>::compare(lhs, rhs) <= 0;
+	}
+
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	constexpr bool operator >=(const BigFixed<Bits, Signed, Mode> &lhs, const BigFixed<Bits, Signed, Mode> &rhs)
+	{
+		return BigFixed<Bits, Signed, Mode>::compare(lhs, rhs) >= 0;
+	}
+
+	/// User-defined literal for compile-time constants
+	//
+	// 123456789012345678901234567890_big (or a hexadecimal, octal or binary
+	// literal) gives a BigFixedUnsigned with enough bits for every digit
+	// written, so large constants are parsed by the compiler instead of at
+	// startup. Use BigFixed's constructors to change the size or type and the
+	// explicit conversion to BigUnsigned or BigInteger to get a BigNumber.
+	namespace Literals
+	{
+		// literalBits gives the number of bits needed for the digits of an
+		// integer literal, rounded up to a whole number of 64-bit items
+		constexpr size_t literalBits(const char *str)
+		{
+			size_t bitsPerDigit = 3322; // thousandths of a bit (a little more than log2(10))
+			size_t numOfDigits = 0;
+
+			if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+			{
+				bitsPerDigit = 4000;
+				str += 2;
+			}
+			else if (str[0] == '0' && (str[1] == 'b' || str[1] == 'B'))
+			{
+				bitsPerDigit = 1000;
+				str += 2;
+			}
+			else if (str[0] == '0')
+				bitsPerDigit = 3000;
+
+			for (; *str != '\0'; ++str)
+			{
+				if (*str != '\'')
+					++numOfDigits;
+			}
+
+			const size_t bits = (numOfDigits * bitsPerDigit + 999) / 1000;
+			return bits <= 64 ? 64 : (bits + 63) / 64 * 64;
+		}
+
+		// the characters of a literal as a string
+		template <char... Chars>
+		struct LiteralString
+		{
+			static constexpr char str[] = { Chars..., '\0' };
+		};
+
+		template <char... Chars>
+		constexpr char LiteralString<Chars...>::str[];
+
+		template <char... Chars>
+		constexpr BigFixedUnsigned<literalBits(LiteralString<Chars...>::str)> operator "" _big()
+		{
+			return BigFixedUnsigned<literalBits(LiteralString<Chars...>::str)>::fromString(LiteralString<Chars...>::str, 0);
+		}
+	} // namespace Literals
+
+	/// ostream operator overload (goes through BigInteger so it follows the same flags)
+	template <size_t Bits, bool Signed, OverflowMode Mode>
+	std::ostream &operator <<(std::ostream &os, const BigFixed<Bits, Signed, Mode> &num)
+	{
+		return os << (BigInteger)num;
+	}
+} // namespace BigNumber
+
+#ifdef BIGFIXED_H_SOURCES
+#include "BigSources.h"
+#endif
+
+#endif // BIGFIXED_H
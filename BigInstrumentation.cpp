@@ -0,0 +1,310 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#include "BigInstrumentation.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace BigNumber
+{
+#ifndef BIGNUMBER_HEADER_ONLY
+	constexpr size_t BigInstrumentation::operationCount;
+	constexpr size_t BigInstrumentation::algorithmCount;
+	constexpr size_t BigInstrumentation::sizeBuckets;
+#endif
+
+	// the counters of one thread. only that thread changes them, so adding is a
+	// load and a store, but they're atomic so statistics can read them anytime
+	struct BigInstrumentation::Counters
+	{
+		typedef std::atomic<std::uint64_t> counter; // one counter
+
+		counter operations[operationCount][sizeBuckets] = {};
+		counter allocations{0};
+		counter allocatedBytes{0};
+		counter copies{0};
+		counter copiedBytes{0};
+		counter calls[algorithmCount] = {};
+		counter nanoseconds[algorithmCount] = {};
+
+		// adds to a counter from the thread that owns it
+		static void add(counter &value, std::uint64_t amount)
+		{
+			value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+
+		// adds every counter to the statistics
+		void addTo(Statistics &stats) const
+		{
+			for (size_t i = 0; i < operationCount; ++i)
+			{
+				for (size_t j = 0; j < sizeBuckets; ++j)
+					stats.operations[i][j] += operations[i][j].load(std::memory_order_relaxed);
+			}
+
+			stats.allocations += allocations.load(std::memory_order_relaxed);
+			stats.allocatedBytes += allocatedBytes.load(std::memory_order_relaxed);
+			stats.copies += copies.load(std::memory_order_relaxed);
+			stats.copiedBytes += copiedBytes.load(std::memory_order_relaxed);
+
+			for (size_t i = 0; i < algorithmCount; ++i)
+			{
+				stats.calls[i] += calls[i].load(std::memory_order_relaxed);
+				stats.nanoseconds[i] += nanoseconds[i].load(std::memory_order_relaxed);
+			}
+		}
+
+		// sets every counter to zero
+		void clear()
+		{
+			for (auto &row : operations)
+			{
+				for (auto &value : row)
+					value.store(0, std::memory_order_relaxed);
+			}
+
+			allocations.store(0, std::memory_order_relaxed);
+			allocatedBytes.store(0, std::memory_order_relaxed);
+			copies.store(0, std::memory_order_relaxed);
+			copiedBytes.store(0, std::memory_order_relaxed);
+
+			for (size_t i = 0; i < algorithmCount; ++i)
+			{
+				calls[i].store(0, std::memory_order_relaxed);
+				nanoseconds[i].store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	// every thread's counters
+	struct BigInstrumentation::Shared
+	{
+		std::mutex lock; // guards everything here
+		std::vector<Counters *> threads; // counters of the running threads
+		Statistics exited; // counts of the threads that have exited
+	};
+
+	// shared is never destroyed so threads that exit while the program is
+	// shutting down (like the thread pool's) can still add their counts
+	BIGNUMBER_INLINE BigInstrumentation::Shared &BigInstrumentation::shared()
+	{
+		static Shared *retVal = new Shared();
+		return *retVal;
+	}
+
+	// threadCounters returns the current thread's counters or nullptr if they were already destroyed
+	BIGNUMBER_INLINE BigInstrumentation::Counters *BigInstrumentation::threadCounters()
+	{
+		static thread_local Counters *counters = nullptr;
+		static thread_local bool destroyed = false;
+
+		// moves the thread's counts into the shared ones when the thread exits
+		struct Owner
+		{
+			~Owner()
+			{
+				Shared &all = shared();
+				std::lock_guard<std::mutex> guard(all.lock);
+
+				counters->addTo(all.exited);
+				all.threads.erase(std::find(all.threads.begin(), all.threads.end(), counters));
+
+				delete counters;
+				counters = nullptr;
+				destroyed = true;
+			}
+		};
+
+		if (!counters && !destroyed)
+		{
+			static thread_local Owner owner; // registers the cleanup for this thread
+			Shared &all = shared();
+			std::lock_guard<std::mutex> guard(all.lock);
+
+			counters = new Counters();
+			all.threads.push_back(counters);
+		}
+
+		return counters;
+	}
+
+	/// Operations of one type of every size
+	BIGNUMBER_INLINE std::uint64_t BigInstrumentation::Statistics::operationTotal(Operation operation) const
+	{
+		const std::uint64_t *row = operations[(size_t)operation];
+		std::uint64_t retVal = 0;
+
+		for (size_t i = 0; i < sizeBuckets; ++i)
+			retVal += row[i];
+
+		return retVal;
+	}
+
+	/// Everything as a JSON object
+	BIGNUMBER_INLINE std::string BigInstrumentation::Statistics::json() const
+	{
+		std::ostringstream out;
+		out << "{\"enabled\":" << (enabled() ? "true" : "false") << ",\"operations\":{";
+
+		// every operation has its total and the sizes that were used, like "2-3":5
+		for (size_t i = 0; i < operationCount; ++i)
+		{
+			out << (i != 0 ? "," : "") << '"' << name((Operation)i) << "\":{\"total\":" << operationTotal((Operation)i) << ",\"limbs\":{";
+			bool first = true;
+
+			for (size_t j = 0; j < sizeBuckets; ++j)
+			{
+				if (operations[i][j] == 0)
+					continue;
+
+				out << (first ? "" : ",") << '"';
+
+				if (j <= 1)
+					out << j;
+				else if (j == sizeBuckets - 1)
+					out << ((size_t)1 << (j - 1)) << '+';
+				else
+					out << ((size_t)1 << (j - 1)) << '-' << (((size_t)1 << j) - 1);
+
+				out << "\":" << operations[i][j];
+				first = false;
+			}
+
+			out << "}}";
+		}
+
+		out << "},\"allocations\":{\"count\":" << allocations << ",\"bytes\":" << allocatedBytes << '}'
+			<< ",\"copies\":{\"count\":" << copies << ",\"bytes\":" << copiedBytes << '}'
+			<< ",\"algorithms\":{";
+
+		for (size_t i = 0; i < algorithmCount; ++i)
+			out << (i != 0 ? "," : "") << '"' << name((Algorithm)i) << "\":{\"calls\":" << calls[i] << ",\"nanoseconds\":" << nanoseconds[i] << '}';
+
+		out << "}}";
+		return out.str();
+	}
+
+	/// True when the library was built with BIGNUMBER_INSTRUMENTATION
+	BIGNUMBER_INLINE bool BigInstrumentation::enabled()
+	{
+#ifdef BIGNUMBER_INSTRUMENTATION
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/// Get the counters of every thread
+	BIGNUMBER_INLINE BigInstrumentation::Statistics BigInstrumentation::statistics()
+	{
+		Shared &all = shared();
+		std::lock_guard<std::mutex> guard(all.lock);
+		Statistics retVal = all.exited;
+
+		for (const Counters *counters : all.threads)
+			counters->addTo(retVal);
+
+		return retVal;
+	}
+
+	/// Reset the counters of every thread (counts other threads add at the same time can be lost)
+	BIGNUMBER_INLINE void BigInstrumentation::resetStatistics()
+	{
+		Shared &all = shared();
+		std::lock_guard<std::mutex> guard(all.lock);
+		all.exited = Statistics();
+
+		for (Counters *counters : all.threads)
+			counters->clear();
+	}
+
+	/// Name of an operation
+	BIGNUMBER_INLINE const char *BigInstrumentation::name(Operation operation)
+	{
+		static const char *const names[operationCount] = { "add", "subtract", "multiply", "square", "divide", "shift", "bitwise", "toString", "fromString" };
+		return names[(size_t)operation];
+	}
+
+	/// Name of an algorithm
+	BIGNUMBER_INLINE const char *BigInstrumentation::name(Algorithm algorithm)
+	{
+		static const char *const names[algorithmCount] = { "schoolbookMultiply", "karatsubaMultiply", "schoolbookSquare", "karatsubaSquare", "limbDivision", "knuthDivision", "toString", "fromString" };
+		return names[(size_t)algorithm];
+	}
+
+	/// Bucket that a size goes in (the number of bits in the size)
+	BIGNUMBER_INLINE size_t BigInstrumentation::sizeBucket(size_t limbs)
+	{
+		size_t retVal = 0;
+
+		while (limbs != 0 && retVal < sizeBuckets - 1)
+		{
+			limbs >>= 1;
+			++retVal;
+		}
+
+		return retVal;
+	}
+
+	/// Count an operation on operands of a size
+	BIGNUMBER_INLINE void BigInstrumentation::countOperation(Operation operation, size_t limbs)
+	{
+		if (Counters *counters = threadCounters())
+			Counters::add(counters->operations[(size_t)operation][sizeBucket(limbs)], 1);
+	}
+
+	/// Count a buffer that was allocated
+	BIGNUMBER_INLINE void BigInstrumentation::countAllocation(size_t bytes)
+	{
+		if (Counters *counters = threadCounters())
+		{
+			Counters::add(counters->allocations, 1);
+			Counters::add(counters->allocatedBytes, bytes);
+		}
+	}
+
+	/// Count shared data that was copied
+	BIGNUMBER_INLINE void BigInstrumentation::countCopy(size_t bytes)
+	{
+		if (Counters *counters = threadCounters())
+		{
+			Counters::add(counters->copies, 1);
+			Counters::add(counters->copiedBytes, bytes);
+		}
+	}
+
+	/// Count time spent in an algorithm
+	BIGNUMBER_INLINE void BigInstrumentation::countTime(Algorithm algorithm, std::chrono::steady_clock::duration time)
+	{
+		if (Counters *counters = threadCounters())
+		{
+			Counters::add(counters->calls[(size_t)algorithm], 1);
+			Counters::add(counters->nanoseconds[(size_t)algorithm], (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+		}
+	}
+} // namespace BigNumber
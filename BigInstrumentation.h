@@ -0,0 +1,145 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGINSTRUMENTATION_H
+#define BIGINSTRUMENTATION_H
+
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGINSTRUMENTATION_H_SOURCES
+#endif
+
+#include "BigConfig.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace BigNumber
+{
+	// BigInstrumentation counts what the library does when the library is built
+	// with BIGNUMBER_INSTRUMENTATION defined: the operations done by type and
+	// size, the buffers allocated, the copies made when shared data is changed
+	// (copy on write) and the time spent in each algorithm. Without it the
+	// counting compiles to nothing and every counter stays at zero. Every thread
+	// counts on its own (so counting is just an add) and statistics adds up the
+	// counts of all the threads, including ones that have exited.
+	class BigInstrumentation
+	{
+	public:
+		/// Operations that are counted (the size is the longest operand in limbs)
+		enum class Operation { Add, Subtract, Multiply, Square, Divide, Shift, Bitwise, ToString, FromString };
+		static constexpr size_t operationCount = 9;
+
+		/// Algorithms that are timed. the time of an algorithm includes the ones it
+		/// uses (a conversion includes its products and divisions)
+		enum class Algorithm { SchoolbookMultiply, KaratsubaMultiply, SchoolbookSquare, KaratsubaSquare, LimbDivision, KnuthDivision, ToString, FromString };
+		static constexpr size_t algorithmCount = 8;
+
+		/// Size buckets. bucket 0 is zero limbs and bucket n is 2^(n-1) limbs up to 2^n - 1 (the last one has everything bigger)
+		static constexpr size_t sizeBuckets = 32;
+
+		/// Counters added up from every thread
+		struct Statistics
+		{
+			std::uint64_t operations[operationCount][sizeBuckets] = {}; // operations by type and size bucket
+			std::uint64_t allocations = 0; // buffers allocated (the ones BigUnsignedPool reuses aren't counted)
+			std::uint64_t allocatedBytes = 0; // bytes in those buffers
+			std::uint64_t copies = 0; // shared data copied so it could be changed
+			std::uint64_t copiedBytes = 0; // bytes copied
+			std::uint64_t calls[algorithmCount] = {}; // times each algorithm was used
+			std::uint64_t nanoseconds[algorithmCount] = {}; // time spent in each algorithm
+
+			/// Operations of one type of every size
+			std::uint64_t operationTotal(Operation) const;
+
+			/// Everything as a JSON object
+			std::string json() const;
+		};
+
+		/// True when the library was built with BIGNUMBER_INSTRUMENTATION
+		static bool enabled();
+
+		/// Get and reset the counters of every thread
+		static Statistics statistics();
+		static void resetStatistics();
+
+		/// Names used in the JSON
+		static const char *name(Operation);
+		static const char *name(Algorithm);
+
+		/// Bucket that a size goes in
+		static size_t sizeBucket(size_t);
+
+		/// Counting (the library uses these through the macros below)
+		static void countOperation(Operation, size_t);
+		static void countAllocation(size_t);
+		static void countCopy(size_t);
+		static void countTime(Algorithm, std::chrono::steady_clock::duration);
+
+		/// Times the algorithm from when it's made until it's destroyed
+		class Timer
+		{
+		public:
+			explicit Timer(Algorithm algorithm) :algorithm(algorithm), start(std::chrono::steady_clock::now()) {}
+			~Timer() { countTime(algorithm, std::chrono::steady_clock::now() - start); }
+
+			Timer(const Timer &) = delete;
+			Timer &operator =(const Timer &) = delete;
+
+		private:
+			Algorithm algorithm;
+			std::chrono::steady_clock::time_point start;
+		};
+
+	private:
+		struct Counters; // the counters of one thread
+		struct Shared; // every thread's counters
+
+		/// Helper functions
+		static Counters *threadCounters();
+		static Shared &shared();
+	};
+} // namespace BigNumber
+
+// the library counts through these so nothing is left when instrumentation is off
+#ifdef BIGNUMBER_INSTRUMENTATION
+#define BIGNUMBER_COUNT_OPERATION(operation, limbs) BigNumber::BigInstrumentation::countOperation(BigNumber::BigInstrumentation::Operation::operation, limbs)
+#define BIGNUMBER_COUNT_ALLOCATION(bytes) BigNumber::BigInstrumentation::countAllocation(bytes)
+#define BIGNUMBER_COUNT_COPY(bytes) BigNumber::BigInstrumentation::countCopy(bytes)
+#define BIGNUMBER_TIME_ALGORITHM(algorithm) const BigNumber::BigInstrumentation::Timer bigInstrumentationTimer(algorithm)
+#else
+#define BIGNUMBER_COUNT_OPERATION(operation, limbs) ((void)0)
+#define BIGNUMBER_COUNT_ALLOCATION(bytes) ((void)0)
+#define BIGNUMBER_COUNT_COPY(bytes) ((void)0)
+#define BIGNUMBER_TIME_ALGORITHM(algorithm) ((void)0)
+#endif
+
+#ifdef BIGINSTRUMENTATION_H_SOURCES
+#include "BigSources.h"
+#endif
+
+#endif // BIGINSTRUMENTATION_H
@@ -24,13 +24,57 @@ Email address: weston925@gmail.com
 */
 
 #include "BigInteger.h"
-
-using namespace std;
+#include "BigInstrumentation.h"
 
 namespace BigNumber
 {
+	// definition of the value returned when there isn't a bit (C++17 defines it in
+	// the class, which header only builds need)
+#ifndef BIGNUMBER_HEADER_ONLY
+	constexpr size_t BigInteger::npos;
+#endif
+
+	namespace detail
+	{
+		typedef Kernels::limb limb; // data type
+
+		// TwosComplement reads the limbs of a value one at a time as two's complement
+		// with endless sign bits. negative values are complemented as they're read
+		// (not the value plus one) so the whole value is never negated
+		class TwosComplement
+		{
+		public:
+			TwosComplement(const limb *limbs, size_t size, bool negative) :limbs(limbs), size(size), negative(negative) {}
+
+			// returns the next limb
+			limb next()
+			{
+				limb value = index < size ? limbs[index] : 0;
+				++index;
+
+				if (negative)
+				{
+					// the carry from adding one goes on until a limb isn't zero
+					value = ~value + carry;
+					carry = carry != 0 && value == 0 ? 1 : 0;
+				}
+
+				return value;
+			}
+
+		private:
+			const limb *limbs;
+			size_t size;
+			bool negative;
+			size_t index = 0;
+			limb carry = 1;
+		};
+	} // namespace detail
+
+	using namespace detail;
+
 	/// Conversion operator to bool
-	BigInteger::operator bool() const
+	BIGNUMBER_INLINE BigInteger::operator bool() const
 	{
 		// this returns false only when the data is zero
 
@@ -43,16 +87,16 @@ namespace BigNumber
 	}
 
 	/// Move assignment operator
-	BigInteger &BigInteger::operator =(BigInteger &&rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator =(BigInteger &&rhs)
 	{
-		data = move(rhs.data);
+		data = std::move(rhs.data);
 		negative = rhs.negative;
 		rhs.negative = false;
 		return *this;
 	}
 
 	/// Bool assignment operator
-	BigInteger &BigInteger::operator =(const bool &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator =(const bool &rhs)
 	{
 		data = rhs; // set the data
 		negative = false; // a boolean value is never negative
@@ -60,53 +104,24 @@ namespace BigNumber
 	}
 
 	/// Addition compound assignment operator
-	BigInteger &BigInteger::operator +=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator +=(const BigInteger &rhs)
 	{
-		if (rhs) // check if not zero
-		{
-			if (*this) // check if not zero
-			{
-				// if they both have the same negative value, leave the
-				// negative the same and add the data
-				if (negative == rhs.negative)
-					data += rhs.data;
-				else
-				{
-					if (data >= rhs.data)
-					{
-						// this data is greater than or equal to rhs's data, so
-						// it is safe to subtract them normally
-						data -= rhs.data;
-
-						if (!data)
-							negative = false; // make sure negative is false when the data is zero
-					}
-					else
-					{
-						// this data is smaller than rhs's data, so subtract
-						// rhs's data from this data and swap the negative
-						data = rhs.data - data;
-						negative = rhs.negative;
-					}
-				}
-			}
-			else
-				operator =(rhs); // this data is zero so just copy rhs
-		}
-
+		// addSigned works on the data in place (adding, subtracting or
+		// subtracting it from rhs's data depending on the signs)
+		addSigned(*this, data, negative, rhs.data, rhs.negative);
 		return *this;
 	}
 
 	/// Subtraction compound assignment operator
-	BigInteger &BigInteger::operator -=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator -=(const BigInteger &rhs)
 	{
-		// change the negative value of rhs and use += since it
-		// covers both positive and negative values
-		return operator +=(-rhs);
+		// flip the sign of rhs without copying it
+		addSigned(*this, data, negative, rhs.data, !rhs.negative);
+		return *this;
 	}
 
 	/// Multiplication compound assignment operator
-	BigInteger &BigInteger::operator *=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator *=(const BigInteger &rhs)
 	{
 		data *= rhs.data;
 
@@ -119,7 +134,7 @@ namespace BigNumber
 	}
 
 	/// Division compound assignment operator
-	BigInteger &BigInteger::operator /=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator /=(const BigInteger &rhs)
 	{
 		data /= rhs.data;
 
@@ -132,7 +147,7 @@ namespace BigNumber
 	}
 
 	/// Modulo compound assignment operator
-	BigInteger &BigInteger::operator %=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator %=(const BigInteger &rhs)
 	{
 		data %= rhs.data;
 
@@ -146,41 +161,28 @@ namespace BigNumber
 	}
 
 	/// Bitwise AND compound assignment operator
-	BigInteger &BigInteger::operator &=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator &=(const BigInteger &rhs)
 	{
-		data &= rhs.data;
-
-		if (data)
-			negative &= rhs.negative;
-		else
-			negative = false; // make sure negative is false when the data is zero
-
+		bitwise(rhs, BitOperation::AND);
 		return *this;
 	}
 
 	/// Bitwise OR compound assignment operator
-	BigInteger &BigInteger::operator |=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator |=(const BigInteger &rhs)
 	{
-		data |= rhs.data;
-		negative |= rhs.negative;
+		bitwise(rhs, BitOperation::OR);
 		return *this;
 	}
 
 	/// Bitwise XOR compound assignment operator
-	BigInteger &BigInteger::operator ^=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator ^=(const BigInteger &rhs)
 	{
-		data ^= rhs.data;
-
-		if (data)
-			negative ^= rhs.negative;
-		else
-			negative = false; // make sure negative is false when the data is zero
-
+		bitwise(rhs, BitOperation::XOR);
 		return *this;
 	}
 
 	/// Bitshift left compound assignment operator
-	BigInteger &BigInteger::operator <<=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator <<=(const BigInteger &rhs)
 	{
 		if (rhs.negative)
 			operator >>=(-rhs); // rhs is negative, so shift the other way
@@ -191,37 +193,60 @@ namespace BigNumber
 	}
 
 	/// Bitshift right compound assignment operator
-	BigInteger &BigInteger::operator >>=(const BigInteger &rhs)
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator >>=(const BigInteger &rhs)
 	{
 		if (rhs.negative)
 			operator <<=(-rhs); // rhs is negative, so shift the other way
-		else
+		else if (negative)
 		{
+			// a negative value rounds toward negative infinity like the built-in types
+			// do, so one more is taken off when any of the bits shifted out are set
+			size_t count;
+			bool bitsLost = true;
+
+			if (rhs.data.toSize(count))
+			{
+				const size_t index = count / dataTypeSize, size = data.pData->size();
+				const dataType *limbs = data.pData->data();
+				bitsLost = false;
+
+				for (size_t i = 0; i < index && i < size && !bitsLost; ++i)
+					bitsLost = limbs[i] != 0;
+
+				if (!bitsLost && index < size)
+					bitsLost = (limbs[index] & (((dataType)1 << (count % dataTypeSize)) - 1)) != 0;
+			}
+
 			data >>= rhs.data;
 
-			if (!data)
-				negative = false; // make sure negative is false when the data is zero
+			if (bitsLost)
+				++data; // the results can't be zero so it stays negative
 		}
+		else
+			data >>= rhs.data;
 
 		return *this;
 	}
 
 	/// Bitwise NOT
-	BigInteger BigInteger::operator ~() const
+	BIGNUMBER_INLINE BigInteger BigInteger::operator ~() const
 	{
-		BigInteger retVal; // return value
+		// in two's complement ~x is -x - 1, which never needs to touch more than the
+		// low limbs of the value: ~x is -(x + 1) when x isn't negative and |x| - 1 when it is
+		BigInteger retVal(*this); // return value
 
-		retVal.data = ~data; // set the data
+		if (negative)
+			--retVal.data;
+		else
+			++retVal.data;
 
-		// only change the negative if the data isn't zero
-		if (retVal.data)
-			retVal.negative = !negative; // flip the negative sign
+		retVal.negative = !negative && retVal.data;
 
-		return move(retVal);
+		return std::move(retVal);
 	}
 
 	/// Unary minus
-	BigInteger BigInteger::operator -() const
+	BIGNUMBER_INLINE BigInteger BigInteger::operator -() const
 	{
 		if (*this) // check if not zero
 		{
@@ -229,57 +254,410 @@ namespace BigNumber
 
 			retVal.negative = !retVal.negative; // flip the negative sign
 
-			return move(retVal);
+			return std::move(retVal);
 		}
 		else
 			return *this;
 	}
 
 	/// Prefix increment
-	BigInteger &BigInteger::operator ++()
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator ++()
 	{
-		return operator +=(1);
+		if (negative)
+		{
+			--data; // -x + 1 is -(x - 1)
+			negative = (bool)data;
+		}
+		else
+			++data;
+
+		return *this;
 	}
 
 	/// Prefix decrement
-	BigInteger &BigInteger::operator --()
+	BIGNUMBER_INLINE BigInteger &BigInteger::operator --()
 	{
-		return operator -=(1);
+		if (negative || !data)
+		{
+			++data; // -x - 1 is -(x + 1)
+			negative = true;
+		}
+		else
+			--data;
+
+		return *this;
 	}
 
 	/// Postfix increment
-	BigInteger BigInteger::operator ++(int unused)
+	BIGNUMBER_INLINE BigInteger BigInteger::operator ++(int unused)
 	{
 		BigInteger temp(*this);
 		operator ++();
-		return move(temp);
+		return std::move(temp);
 	}
 
 	/// Postfix decrement
-	BigInteger BigInteger::operator --(int unused)
+	BIGNUMBER_INLINE BigInteger BigInteger::operator --(int unused)
 	{
 		BigInteger temp(*this);
 		operator --();
-		return move(temp);
+		return std::move(temp);
+	}
+
+	/// Hash of the value
+	BIGNUMBER_INLINE size_t BigInteger::hash() const
+	{
+		// flip every bit for negative values so x and -x hash differently
+		const size_t retVal = data.hash();
+		return negative ? ~retVal : retVal;
+	}
+
+	// A negative value -x is ~(x - 1) in two's complement. below the lowest set bit
+	// of x (bit z), x - 1 has ones so the two's complement has zeros, bit z is set
+	// in both, and above it the bits are the inverted bits of x. the bit operations
+	// use that to work on x directly without making x - 1
+
+	/// Check if a bit is set
+	BIGNUMBER_INLINE bool BigInteger::testBit(size_t bit) const
+	{
+		if (!negative)
+			return data.testBit(bit);
+
+		const size_t lowest = data.countTrailingZeros();
+
+		if (bit > lowest)
+			return !data.testBit(bit);
+
+		return bit == lowest;
+	}
+
+	/// Set a bit
+	BIGNUMBER_INLINE void BigInteger::setBit(size_t bit)
+	{
+		if (!negative)
+			data.setBit(bit);
+		else
+		{
+			const size_t lowest = data.countTrailingZeros();
+
+			if (bit > lowest)
+				data.clearBit(bit); // the bit is inverted
+			else if (bit < lowest)
+				data.subtractBit(bit); // adding the bit to -x takes it away from x
+		}
+	}
+
+	/// Clear a bit
+	BIGNUMBER_INLINE void BigInteger::clearBit(size_t bit)
+	{
+		if (!negative)
+			data.clearBit(bit);
+		else
+		{
+			const size_t lowest = data.countTrailingZeros();
+
+			if (bit > lowest)
+				data.setBit(bit); // the bit is inverted
+			else if (bit == lowest)
+				data.addBit(bit); // taking the bit away from -x adds it to x
+		}
+	}
+
+	/// Flip a bit
+	BIGNUMBER_INLINE void BigInteger::flipBit(size_t bit)
+	{
+		if (!negative)
+			data.flipBit(bit);
+		else
+		{
+			const size_t lowest = data.countTrailingZeros();
+
+			if (bit > lowest)
+				data.flipBit(bit);
+			else if (bit < lowest)
+				data.subtractBit(bit);
+			else
+				data.addBit(bit);
+		}
+	}
+
+	/// Number of bits without the sign bits
+	BIGNUMBER_INLINE size_t BigInteger::bitLength() const
+	{
+		const size_t length = data.bitLength();
+
+		// x - 1 is one bit shorter than x when x is a power of two
+		if (negative && data.countTrailingZeros() == length - 1)
+			return length - 1;
+
+		return length;
+	}
+
+	/// Number of bits that are different from the sign bits
+	BIGNUMBER_INLINE size_t BigInteger::popcount() const
+	{
+		const size_t count = data.popcount();
+
+		// x - 1 has the zeros below the lowest set bit of x set and that bit cleared
+		if (negative)
+			return count - 1 + data.countTrailingZeros();
+
+		return count;
+	}
+
+	/// Number of zero bits below the lowest set bit
+	BIGNUMBER_INLINE size_t BigInteger::countTrailingZeros() const
+	{
+		return data.countTrailingZeros(); // it's the same for a value and its negative
+	}
+
+	/// Position of the first bit at or after start with the value
+	BIGNUMBER_INLINE size_t BigInteger::scanBit(size_t start, bool value) const
+	{
+		if (!negative)
+			return data.scanBit(start, value);
+
+		const size_t lowest = data.countTrailingZeros();
+
+		// above the lowest set bit the bits are inverted
+		if (start > lowest)
+			return data.scanBit(start, !value);
+
+		// the lowest set bit is the first set bit and everything below it is clear
+		if (value)
+			return lowest;
+
+		if (start < lowest)
+			return start;
+
+		return data.scanBit(lowest + 1, true);
 	}
 
 	/// Equal to operator
-	bool operator ==(const BigInteger &lhs, const BigInteger &rhs)
+	BIGNUMBER_INLINE bool operator ==(const BigInteger &lhs, const BigInteger &rhs)
 	{
 		return lhs.negative == rhs.negative && lhs.data == rhs.data;
 	}
 
 	/// Less than operator
-	bool operator <(const BigInteger &lhs, const BigInteger &rhs)
+	BIGNUMBER_INLINE bool operator <(const BigInteger &lhs, const BigInteger &rhs)
+	{
+		return lhs.compare(rhs) < 0;
+	}
+
+	/// Three-way comparison
+	BIGNUMBER_INLINE int BigInteger::compare(const BigInteger &rhs) const
+	{
+		// the negative one is smaller when the signs are different
+		if (negative != rhs.negative)
+			return negative ? -1 : 1;
+
+		// both are negative so the bigger magnitude is the smaller value
+		const int retVal = data.compare(rhs.data);
+		return negative ? -retVal : retVal;
+	}
+
+	// bitwise does a bitwise operation on the two's complement of this and rhs. when
+	// they're both positive it's the same as doing it on the data. otherwise both
+	// values are complemented as they're read, the operation is done a limb at a time,
+	// and the results are complemented back if they're negative
+	BIGNUMBER_INLINE void BigInteger::bitwise(const BigInteger &rhs, BitOperation operation)
 	{
-		if (lhs.negative == rhs.negative) // check if the negatives are the same
+		if (!negative && !rhs.negative)
 		{
-			if (!lhs.negative)
-				return lhs.data < rhs.data; // both are positive so return true if lhs is less than rhs
-			else
-				return rhs.data < lhs.data; // both are negative so return true if rhs is less than lhs
+			switch (operation)
+			{
+			case BitOperation::AND:
+				data &= rhs.data;
+				break;
+			case BitOperation::OR:
+				data |= rhs.data;
+				break;
+			case BitOperation::XOR:
+				data ^= rhs.data;
+				break;
+			}
+
+			return;
+		}
+
+		const size_t size = data ? data.pData->size() : 0, rSize = rhs.data ? rhs.data.pData->size() : 0;
+		const size_t resultSize = std::max(size, rSize) + 1; // one more for the sign bits
+		bool resultNegative = false;
+		BIGNUMBER_COUNT_OPERATION(Bitwise, std::max(size, rSize));
+
+		switch (operation)
+		{
+		case BitOperation::AND:
+			resultNegative = negative && rhs.negative;
+			break;
+		case BitOperation::OR:
+			resultNegative = negative || rhs.negative;
+			break;
+		case BitOperation::XOR:
+			resultNegative = negative != rhs.negative;
+			break;
+		}
+
+		// the results go in their own buffer since this and rhs are read as they're written
+		BigUnsigned results;
+		results.resetData(resultSize);
+		results.pData->resize(resultSize);
+
+		TwosComplement a(size != 0 ? data.pData->data() : nullptr, size, negative);
+		TwosComplement b(rSize != 0 ? rhs.data.pData->data() : nullptr, rSize, rhs.negative);
+		TwosComplement out(results.pData->data(), resultSize, resultNegative);
+		dataType *limbs = results.pData->data();
+
+		for (size_t i = 0; i < resultSize; ++i)
+		{
+			switch (operation)
+			{
+			case BitOperation::AND:
+				limbs[i] = a.next() & b.next();
+				break;
+			case BitOperation::OR:
+				limbs[i] = a.next() | b.next();
+				break;
+			case BitOperation::XOR:
+				limbs[i] = a.next() ^ b.next();
+				break;
+			}
+
+			// negative results are complemented back the same way, a limb at a time
+			limbs[i] = out.next();
+		}
+
+		results.removeLeadingZeros();
+		data = std::move(results);
+		negative = resultNegative && data;
+	}
+
+	// addSigned sets out to a plus b using the magnitudes and signs of both, which
+	// lets the three-address functions flip the sign of b without copying it. out's
+	// data can be a or b; the BigUnsigned functions then work in out's buffer
+	BIGNUMBER_INLINE void BigInteger::addSigned(BigInteger &out, const BigUnsigned &a, bool aNegative, const BigUnsigned &b, bool bNegative)
+	{
+		if (aNegative == bNegative)
+		{
+			// they both have the same sign so add the data
+			add(out.data, a, b);
+			out.negative = aNegative;
+		}
+		else if (a >= b)
+		{
+			// a's data is greater than or equal to b's data, so it
+			// is safe to subtract them normally
+			sub(out.data, a, b);
+			out.negative = aNegative;
+		}
+		else
+		{
+			// a's data is smaller than b's data, so subtract a's data
+			// from b's data and use b's sign
+			sub(out.data, b, a);
+			out.negative = bNegative;
+		}
+
+		if (!out.data)
+			out.negative = false; // make sure negative is false when the data is zero
+	}
+
+	/// Three-address addition (out = a + b)
+	BIGNUMBER_INLINE void add(BigInteger &out, const BigInteger &a, const BigInteger &b)
+	{
+		BigInteger::addSigned(out, a.data, a.negative, b.data, b.negative);
+	}
+
+	/// Three-address subtraction (out = a - b)
+	BIGNUMBER_INLINE void sub(BigInteger &out, const BigInteger &a, const BigInteger &b)
+	{
+		// subtracting is adding with b's sign flipped
+		BigInteger::addSigned(out, a.data, a.negative, b.data, !b.negative);
+	}
+
+	/// Three-address multiplication (out = a * b)
+	BIGNUMBER_INLINE void mul(BigInteger &out, const BigInteger &a, const BigInteger &b)
+	{
+		// get the sign first since out can be a or b
+		const bool negative = a.negative != b.negative;
+
+		mul(out.data, a.data, b.data);
+		out.negative = out.data ? negative : false; // make sure negative is false when the data is zero
+	}
+
+	/// Three-address multiply and add (out += a * b)
+	BIGNUMBER_INLINE void addmul(BigInteger &out, const BigInteger &a, const BigInteger &b)
+	{
+		const bool productNegative = a.negative != b.negative;
+
+		if (!out || out.negative == productNegative)
+		{
+			// the product has the same sign as out so the data can be added in place
+			addmul(out.data, a.data, b.data);
+			out.negative = out.data ? productNegative : false;
 		}
 		else
-			return lhs.negative; // the negatives are different so return true if lhs is the negative one
+		{
+			// the signs are different so the product is needed to know
+			// the sign of the results. the temporary's buffer comes
+			// from the pool
+			BigUnsigned product;
+			mul(product, a.data, b.data);
+			BigInteger::addSigned(out, out.data, out.negative, product, productNegative);
+		}
+	}
+
+	/// Three-address multiply and subtract (out -= a * b)
+	BIGNUMBER_INLINE void submul(BigInteger &out, const BigInteger &a, const BigInteger &b)
+	{
+		// subtracting the product is adding it with the sign flipped
+		const bool productNegative = a.negative == b.negative;
+
+		if (!out || out.negative == productNegative)
+		{
+			// the flipped product has the same sign as out so the data can be added in place
+			addmul(out.data, a.data, b.data);
+			out.negative = out.data ? productNegative : false;
+		}
+		else
+		{
+			// the signs are different so the product is needed to know
+			// the sign of the results. the temporary's buffer comes
+			// from the pool
+			BigUnsigned product;
+			mul(product, a.data, b.data);
+			BigInteger::addSigned(out, out.data, out.negative, product, productNegative);
+		}
+	}
+
+	/// Three-address division (out = a / b)
+	BIGNUMBER_INLINE void div(BigInteger &out, const BigInteger &a, const BigInteger &b)
+	{
+		// the results are positive when the signs are the same
+		const bool negative = a.negative != b.negative;
+
+		div(out.data, a.data, b.data);
+		out.negative = out.data ? negative : false;
+	}
+
+	/// Three-address modulus (out = a % b)
+	BIGNUMBER_INLINE void mod(BigInteger &out, const BigInteger &a, const BigInteger &b)
+	{
+		// the remainder has the same sign as a no matter what b's sign is
+		const bool negative = a.negative;
+
+		mod(out.data, a.data, b.data);
+		out.negative = out.data ? negative : false;
+	}
+
+	/// Three-address division with remainder (q = a / b and r = a % b)
+	BIGNUMBER_INLINE void divMod(BigInteger &q, BigInteger &r, const BigInteger &a, const BigInteger &b)
+	{
+		const bool qNegative = a.negative != b.negative, rNegative = a.negative;
+
+		divMod(q.data, r.data, a.data, b.data);
+		q.negative = q.data ? qNegative : false;
+		r.negative = r.data ? rNegative : false;
 	}
 } // namespace BigNumber
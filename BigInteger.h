@@ -26,6 +26,12 @@ Email address: weston925@gmail.com
 #ifndef BIGINTEGER_H
 #define BIGINTEGER_H
 
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGINTEGER_H_SOURCES
+#endif
+
 #include "BigUnsigned.h"
 
 namespace BigNumber
@@ -34,12 +40,31 @@ namespace BigNumber
 	bool operator ==(const BigInteger &, const BigInteger &);
 	bool operator <(const BigInteger &, const BigInteger &);
 
+	/// Three-address arithmetic (works the same as the BigUnsigned versions)
+	void add(BigInteger &, const BigInteger &, const BigInteger &);
+	void sub(BigInteger &, const BigInteger &, const BigInteger &);
+	void mul(BigInteger &, const BigInteger &, const BigInteger &);
+	void addmul(BigInteger &, const BigInteger &, const BigInteger &);
+	void submul(BigInteger &, const BigInteger &, const BigInteger &);
+	void div(BigInteger &, const BigInteger &, const BigInteger &);
+	void mod(BigInteger &, const BigInteger &, const BigInteger &);
+	void divMod(BigInteger &, BigInteger &, const BigInteger &, const BigInteger &);
+
 	class BigInteger
 	{
 		/// Friend classes and functions
 		friend BigIntegerUtil;
+		template <size_t, bool, OverflowMode> friend class BigFixed;
 		friend bool operator ==(const BigInteger &, const BigInteger &);
 		friend bool operator <(const BigInteger &, const BigInteger &);
+		friend void add(BigInteger &, const BigInteger &, const BigInteger &);
+		friend void sub(BigInteger &, const BigInteger &, const BigInteger &);
+		friend void mul(BigInteger &, const BigInteger &, const BigInteger &);
+		friend void addmul(BigInteger &, const BigInteger &, const BigInteger &);
+		friend void submul(BigInteger &, const BigInteger &, const BigInteger &);
+		friend void div(BigInteger &, const BigInteger &, const BigInteger &);
+		friend void mod(BigInteger &, const BigInteger &, const BigInteger &);
+		friend void divMod(BigInteger &, BigInteger &, const BigInteger &, const BigInteger &);
 
 	public:
 		/// Constructor
@@ -70,7 +95,8 @@ namespace BigNumber
 		BigInteger &operator =(const bool &);
 		template <typename T, EnableIfIntegral<T> = 0> BigInteger &operator =(const T &);
 
-		/// Compound assignment operators
+		/// Compound assignment operators. the bitwise operators and right shifts work as if the value
+		/// was stored in two's complement with an endless number of sign bits (like the built-in types)
 		BigInteger &operator +=(const BigInteger &);
 		BigInteger &operator -=(const BigInteger &);
 		BigInteger &operator *=(const BigInteger &);
@@ -96,13 +122,41 @@ namespace BigNumber
 		BigInteger operator ++(int);
 		BigInteger operator --(int);
 
+		/// Three-way comparison (returns -1, 0 or 1 when this is less than, equal to or
+		/// greater than the value). integral values are compared without converting them
+		int compare(const BigInteger &) const;
+		template <typename T, EnableIfIntegral<T> = 0> int compare(const T &) const;
+
+		/// Hash of the value (what std::hash uses)
+		size_t hash() const;
+
+		/// Bit operations. like the bitwise operators these work on the two's complement
+		/// form, so a negative value has an endless number of set bits above its magnitude
+		bool testBit(size_t) const;
+		void setBit(size_t);
+		void clearBit(size_t);
+		void flipBit(size_t);
+		size_t bitLength() const; // number of bits without the sign bits (zero for zero and -1)
+		size_t popcount() const; // number of bits that are different from the sign bits
+		size_t countTrailingZeros() const; // zero bits below the lowest set bit (npos for zero)
+		size_t scanBit(size_t, bool) const; // first bit at or after a position with the value (npos if there isn't one)
+
+		/// Returned by the bit operations when there isn't a bit to return
+		static constexpr size_t npos = BigUnsigned::npos;
+
 	private:
 		typedef BigUnsigned::dataType dataType; // data type
 		typedef BigUnsigned::colType colType; // collection type
-		static const size_t dataTypeSize = 8 * sizeof(dataType); // number of bits
+		static constexpr size_t dataTypeSize = 8 * sizeof(dataType); // number of bits
 
 		BigUnsigned data;
 		bool negative = false;
+
+		enum class BitOperation { AND, OR, XOR }; // bitwise operations
+
+		/// Helper functions
+		static void addSigned(BigInteger &, const BigUnsigned &, bool, const BigUnsigned &, bool);
+		void bitwise(const BigInteger &, BitOperation);
 	};
 
 	/// Conversion operator to integral type
@@ -126,7 +180,7 @@ namespace BigNumber
 					// the smallest possible value of the return type
 					// and throw an underflow error if it isn't
 
-					if (*this >= std::numeric_limits<T>::min())
+					if (compare(std::numeric_limits<T>::min()) >= 0)
 					{
 						// this next if statement should always be true but it's here
 						// just in case some idiot decides to change the class data
@@ -138,20 +192,12 @@ namespace BigNumber
 							// the size of the class's data type is smaller than
 							// the return data type so it is possible for there
 							// to be more than one item in the data collection.
+							// put them together starting with the most significant
+							// one (shifting as unsigned so the sign bit can be set)
+							typedef typename std::make_unsigned<T>::type unsignedType;
 
-							auto iter = begin(*data.pData);
-
-							for (size_t i = 0; i < sizeof(T) / sizeof(dataType); ++i)
-							{
-								// shift the return value to the right
-								retVal >>= dataTypeSize;
-
-								if (iter != end(*data.pData)) // check if there is more data
-								{
-									memcpy(&retVal, &*iter, sizeof(dataType)); // copy the data to the return value
-									++iter; // increment the iterator
-								}
-							}
+							for (auto iter = std::rbegin(*data.pData); iter != std::rend(*data.pData); ++iter)
+								retVal = (T)(((unsignedType)retVal << dataTypeSize) | *iter);
 						}
 
 						// it is possible to set the smallest possible
@@ -159,7 +205,7 @@ namespace BigNumber
 						// value, it is already negative so only
 						// multiply it by -1 when it isn't that value
 
-						if (retVal << 1 != 0)
+						if (retVal != std::numeric_limits<T>::min())
 							retVal *= -1;
 					}
 					else
@@ -175,41 +221,38 @@ namespace BigNumber
 		return retVal;
 	}
 
-	/// Integral assignment operator
+	/// Three-way comparison with integral type
 	template <typename T, EnableIfIntegral<T>>
-	BigInteger &BigInteger::operator =(const T &rhs)
+	int BigInteger::compare(const T &rhs) const
 	{
-		if (rhs < 0) // check if rhs is negative
+		if (rhs < 0)
 		{
-			// this can use the data's assignment operator
-			// for every situation except when rhs is T's
-			// smallest possible value
+			if (!negative)
+				return 1; // this is positive so it's bigger
 
-			if (rhs << 1 != 0) // check if rhs is not T's smallest possible value
-				data = rhs * -1;
-			else
-			{
-				// set the data to zero
-				data.clearData();
-
-				// this next if statement should always be true. see comments
-				// in the function above this one as to why it could be false
-				// and why it's here
-				if (sizeof(dataType) >= sizeof(T))
-					data.pData->push_back((dataType)rhs); // insert rhs into the data
-				else
-				{
-					// size of the class's data type is smaller than
-					// rhs's data type, so it takes more than one
-					// insertion to get all of rhs's data
+			// both are negative so the bigger magnitude is the smaller value. the
+			// magnitude of rhs is found as unsigned so T's smallest value works too
+			typedef MakeUnsigned<T> unsignedType;
+			return -data.compare((unsignedType)(0 - (unsignedType)rhs));
+		}
 
-					// insert zero into data the number of times T is bigger than dataType
-					data.pData->insert(begin(*data.pData), sizeof(T) / sizeof(dataType), 0);
+		if (negative)
+			return -1; // rhs is positive so it's bigger
 
-					// copy rhs into the last item
-					memcpy(&data.pData->back(), &rhs, sizeof(dataType));
-				}
-			}
+		return data.compare(rhs);
+	}
+
+	/// Integral assignment operator
+	template <typename T, EnableIfIntegral<T>>
+	BigInteger &BigInteger::operator =(const T &rhs)
+	{
+		if (rhs < 0) // check if rhs is negative
+		{
+			// negate rhs as unsigned so T's smallest possible value works
+			// too (its magnitude doesn't fit in T) and use the data's
+			// assignment operator
+			typedef MakeUnsigned<T> unsignedType;
+			data = (unsignedType)(0 - (unsignedType)rhs);
 
 			// rhs is negative so set negative to true
 			negative = true;
@@ -228,17 +271,23 @@ namespace BigNumber
 	/// Arithmetic operators
 	inline BigInteger operator +(const BigInteger &lhs, const BigInteger &rhs)
 	{
-		return std::move(BigInteger(lhs) += rhs);
+		BigInteger retVal;
+		add(retVal, lhs, rhs);
+		return retVal;
 	}
 
 	inline BigInteger operator -(const BigInteger &lhs, const BigInteger &rhs)
 	{
-		return std::move(BigInteger(lhs) -= rhs);
+		BigInteger retVal;
+		sub(retVal, lhs, rhs);
+		return retVal;
 	}
 
 	inline BigInteger operator *(const BigInteger &lhs, const BigInteger &rhs)
 	{
-		return std::move(BigInteger(lhs) *= rhs);
+		BigInteger retVal;
+		mul(retVal, lhs, rhs);
+		return retVal;
 	}
 
 	inline BigInteger operator /(const BigInteger &lhs, const BigInteger &rhs)
@@ -347,6 +396,110 @@ namespace BigNumber
 	{
 		return !(lhs < rhs);
 	}
+
+	/// Comparison operators with integral types
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator ==(const BigInteger &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) == 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator !=(const BigInteger &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) != 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator <(const BigInteger &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) < 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator >(const BigInteger &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) > 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator <=(const BigInteger &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) <= 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator >=(const BigInteger &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) >= 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator ==(const T &lhs, const BigInteger &rhs)
+	{
+		return rhs.compare(lhs) == 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator !=(const T &lhs, const BigInteger &rhs)
+	{
+		return rhs.compare(lhs) != 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator <(const T &lhs, const BigInteger &rhs)
+	{
+		return rhs.compare(lhs) > 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator >(const T &lhs, const BigInteger &rhs)
+	{
+		return rhs.compare(lhs) < 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator <=(const T &lhs, const BigInteger &rhs)
+	{
+		return rhs.compare(lhs) >= 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator >=(const T &lhs, const BigInteger &rhs)
+	{
+		return rhs.compare(lhs) <= 0;
+	}
+
+#ifdef BIGNUMBER_THREE_WAY_COMPARISON
+	/// Three-way comparison operators
+	inline std::strong_ordering operator <=>(const BigInteger &lhs, const BigInteger &rhs)
+	{
+		return lhs.compare(rhs) <=> 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline std::strong_ordering operator <=>(const BigInteger &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) <=> 0;
+	}
+#endif
 } // namespace BigNumber
 
+namespace std
+{
+	/// Hash for unordered containers
+	template <>
+	struct hash<BigNumber::BigInteger>
+	{
+		size_t operator ()(const BigNumber::BigInteger &value) const
+		{
+			return value.hash();
+		}
+	};
+} // namespace std
+
+#ifdef BIGINTEGER_H_SOURCES
+#include "BigSources.h"
+#endif
+
 #endif // BIGINTEGER_H
@@ -24,45 +24,349 @@ Email address: weston925@gmail.com
 */
 
 #include "BigIntegerUtil.h"
-
-using namespace std;
+#include "BigInstrumentation.h"
+#include "BigThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 namespace BigNumber
 {
+	namespace detail
+	{
+		typedef Kernels::limb limb; // data type
+
+		// returns the number of bits in a digit when the base is a power of two or zero when it isn't
+		BIGNUMBER_INLINE unsigned int bitsPerDigit(unsigned int base)
+		{
+			unsigned int bits = 0;
+
+			while (((unsigned int)1 << bits) < base)
+				++bits;
+
+			return ((unsigned int)1 << bits) == base ? bits : 0;
+		}
+
+		// returns the character for a digit
+		BIGNUMBER_INLINE char digitChar(unsigned int digit)
+		{
+			return digit < 10 ? char('0' + digit) : char('a' + digit - 10);
+		}
+
+		// returns the value of a digit or the base if the character isn't a digit of the base
+		BIGNUMBER_INLINE unsigned int digitValue(char digit, unsigned int base)
+		{
+			unsigned int value = base;
+
+			if (isdigit(digit))
+				value = (unsigned int)(digit - '0');
+			else if (islower(digit))
+				value = (unsigned int)(digit - 'a') + 10;
+			else if (isupper(digit))
+				value = (unsigned int)(digit - 'A') + 10;
+
+			return value < base ? value : base;
+		}
+
+		// collects small factors into products that fill a limb so the
+		// product tree doesn't start with lots of tiny multiplications
+		class Factors
+		{
+		public:
+			void add(size_t factor)
+			{
+				if (factor > std::numeric_limits<limb>::max())
+					leaves.emplace_back(factor); // too big for a limb
+				else
+				{
+					if ((limb)factor > std::numeric_limits<limb>::max() / chunk)
+					{
+						leaves.emplace_back(chunk);
+						chunk = 1;
+					}
+
+					chunk *= (limb)factor;
+				}
+			}
+
+			const std::vector<BigUnsigned> &finish()
+			{
+				if (chunk != 1)
+					leaves.emplace_back(chunk);
+
+				chunk = 1;
+				return leaves;
+			}
+
+		private:
+			std::vector<BigUnsigned> leaves;
+			limb chunk = 1;
+		};
+
+		// returns every prime up to n (sieve of Eratosthenes over the odd numbers)
+		BIGNUMBER_INLINE std::vector<size_t> primesUpTo(size_t n)
+		{
+			std::vector<size_t> primes;
+
+			if (n < 2)
+				return primes;
+
+			primes.push_back(2);
+			std::vector<bool> composite(n / 2 + 1); // composite[i] is for 2i + 1
+
+			for (size_t i = 1; 2 * i + 1 <= n; ++i)
+			{
+				if (composite[i])
+					continue;
+
+				const size_t prime = 2 * i + 1;
+				primes.push_back(prime);
+
+				for (size_t j = prime * prime / 2; prime <= n / prime && j <= n / 2; j += prime)
+					composite[j] = true;
+			}
+
+			return primes;
+		}
+
+		// runs both functions, on different threads when the number is big enough
+		BIGNUMBER_INLINE void runBoth(size_t size, const std::function<void()> &first, const std::function<void()> &second)
+		{
+			if (size >= BigThreadPool::parallelThreshold() && BigThreadPool::threadCount() > 1)
+			{
+				const std::function<void()> tasks[] = { first, second };
+				BigThreadPool::run(tasks, 2);
+			}
+			else
+			{
+				first();
+				second();
+			}
+		}
+	} // namespace detail
+
+	using namespace detail;
+
+	// a base and the powers of it used by the conversions. a chunk is the most
+	// digits that fit in a limb and powers[i] is the base to the power of the
+	// number of digits in 2^i chunks
+	struct BigIntegerUtil::Radix
+	{
+		unsigned int base; // the base
+		unsigned int digits; // number of digits in a chunk
+		limb chunk; // base ^ digits
+		std::vector<BigUnsigned> powers; // chunk ^ (2 ^ i)
+
+		explicit Radix(unsigned int base) :base(base), digits(1), chunk(base)
+		{
+			while (chunk <= std::numeric_limits<limb>::max() / base)
+			{
+				chunk *= base;
+				++digits;
+			}
+
+			powers.emplace_back(chunk);
+		}
+
+		// adds the next power to the list
+		void square()
+		{
+			BigUnsigned next;
+			mul(next, powers.back(), powers.back());
+			powers.push_back(std::move(next));
+		}
+	};
+
+	// writeDigits writes exactly digits * 2^level digits of value (with leading
+	// zeros). value has to be less than powers[level]. big values are split in
+	// half by dividing by the power below and both halves are written at once
+	BIGNUMBER_INLINE void BigIntegerUtil::writeDigits(const BigUnsigned &value, const Radix &radix, size_t level, char *out)
+	{
+		const size_t size = value ? value.pData->size() : 0;
+
+		// numbers under the conversion threshold take one limb of digits at a time
+		if (level == 0 || size < Kernels::thresholds().conversion)
+		{
+			// take one chunk of digits off the bottom at a time
+			colType limbs(size);
+			size_t remaining = size;
+			char *end = out + (radix.digits << level);
+
+			if (size != 0)
+				std::copy(value.pData->begin(), value.pData->end(), limbs.begin());
+
+			while (end != out)
+			{
+				limb chunk = 0;
+
+				if (remaining != 0)
+				{
+					chunk = Kernels::divRem1(limbs.data(), limbs.data(), remaining, radix.chunk);
+					remaining = Kernels::normalizedSize(limbs.data(), remaining);
+				}
+
+				for (unsigned int i = 0; i < radix.digits; ++i)
+				{
+					*--end = digitChar((unsigned int)(chunk % radix.base));
+					chunk /= radix.base;
+				}
+			}
+
+			return;
+		}
+
+		BigUnsigned high, low;
+		divMod(high, low, value, radix.powers[level - 1]);
+
+		runBoth(size,
+			[&]() { writeDigits(high, radix, level - 1, out); },
+			[&]() { writeDigits(low, radix, level - 1, out + (radix.digits << (level - 1))); });
+	}
+
+	// readDigits turns digit values (not characters) into a number. big numbers
+	// are split so the low part is a power of two chunks and both parts are read
+	// at once. every power needed has to be in the radix already
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::readDigits(const char *digits, size_t count, const Radix &radix)
+	{
+		if (count <= radix.digits * Kernels::thresholds().conversion)
+		{
+			// add one chunk of digits at a time, starting with the partial one
+			BigUnsigned retVal;
+			retVal.resetData(count / radix.digits + 1);
+			colType &limbs = *retVal.pData;
+			size_t first = count % radix.digits;
+
+			if (first == 0)
+				first = radix.digits;
+
+			for (size_t done = 0, take = first; done < count; done += take, take = radix.digits)
+			{
+				limb chunk = 0, scale = 1;
+
+				for (size_t i = 0; i < take; ++i)
+				{
+					chunk = chunk * radix.base + (limb)digits[done + i];
+					scale *= radix.base;
+				}
+
+				limb carry = Kernels::mul1(limbs.data(), limbs.data(), limbs.size(), scale);
+				carry += Kernels::add1(limbs.data(), limbs.data(), limbs.size(), chunk);
+
+				if (carry != 0)
+					limbs.push_back(carry);
+			}
+
+			retVal.removeLeadingZeros();
+			return retVal;
+		}
+
+		size_t level = 0;
+
+		while ((radix.digits << (level + 1)) < count)
+			++level;
+
+		const size_t lowCount = radix.digits << level;
+		BigUnsigned high, low;
+
+		runBoth(count / radix.digits,
+			[&]() { high = readDigits(digits, count - lowCount, radix); },
+			[&]() { low = readDigits(digits + count - lowCount, lowCount, radix); });
+
+		// low += high * base ^ lowCount. the halves are about the same size, so the
+		// product is well above the multiply threshold and addmul uses Karatsuba for it
+		addmul(low, high, radix.powers[level]);
+		return low;
+	}
+
+	// writePowerOfTwo writes the digits straight from the bits
+	BIGNUMBER_INLINE std::string BigIntegerUtil::writePowerOfTwo(const BigUnsigned &value, unsigned int bits)
+	{
+		const colType &limbs = *value.pData;
+		const size_t size = limbs.size(), limbBits = Kernels::limbBits;
+		const limb mask = ((limb)1 << bits) - 1;
+
+		// count the bits without the leading zeros
+		size_t total = size * limbBits;
+
+		for (limb top = limbs.back(); (top >> (limbBits - 1)) == 0; top <<= 1)
+			--total;
+
+		std::string results((total + bits - 1) / bits, '0');
+		auto out = results.rbegin();
+
+		for (size_t bit = 0; bit < total; bit += bits)
+		{
+			const size_t index = bit / limbBits, shift = bit % limbBits;
+			limb digit = limbs[index] >> shift;
+
+			if (shift + bits > limbBits && index + 1 < size)
+				digit |= limbs[index + 1] << (limbBits - shift);
+
+			*out++ = digitChar((unsigned int)(digit & mask));
+		}
+
+		return results;
+	}
+
+	// readPowerOfTwo puts the bits of the digit values straight into the limbs
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::readPowerOfTwo(const std::string &digits, unsigned int bits)
+	{
+		const size_t limbBits = Kernels::limbBits;
+
+		BigUnsigned retVal;
+		retVal.resetData(digits.size() * bits / limbBits + 1);
+		colType &limbs = *retVal.pData;
+		limbs.resize(digits.size() * bits / limbBits + 1);
+
+		size_t bit = 0;
+
+		for (auto iter = digits.rbegin(); iter != digits.rend(); ++iter, bit += bits)
+		{
+			const size_t index = bit / limbBits, shift = bit % limbBits;
+			limbs[index] |= (limb)*iter << shift;
+
+			if (shift + bits > limbBits)
+				limbs[index + 1] |= (limb)*iter >> (limbBits - shift);
+		}
+
+		retVal.removeLeadingZeros();
+		return retVal;
+	}
+
 	/// converts a BigUnsigned to a BigInteger
-	BigInteger BigIntegerUtil::toSigned(const BigUnsigned &value)
+	BIGNUMBER_INLINE BigInteger BigIntegerUtil::toSigned(const BigUnsigned &value)
 	{
 		BigInteger retVal;
 		retVal.data = value;
-		return move(retVal);
+		return std::move(retVal);
 	}
 
 	/// converts a BigInteger to a BigUnsigned
-	BigUnsigned BigIntegerUtil::toUnsigned(const BigInteger &value)
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::toUnsigned(const BigInteger &value)
 	{
 		if (value.negative)
-			throw runtime_error("BigIntegerUtil::toUnsigned: cannot convert a negative number to an unsigned data type");
+			throw std::runtime_error("BigIntegerUtil::toUnsigned: cannot convert a negative number to an unsigned data type");
 
 		return value.data;
 	}
 
 	/// converts a string to a BigUnsigned
-	BigUnsigned BigIntegerUtil::stringToBigUnsigned(string _str, unsigned int base)
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::stringToBigUnsigned(std::string _str, unsigned int base)
 	{
 		if (base == 1 || base > 36)
-			throw out_of_range("BigIntegerUtil::stringToBigUnsigned: invalid base number");
+			throw std::out_of_range("BigIntegerUtil::stringToBigUnsigned: invalid base number");
 
 		if (_str.empty())
-			throw runtime_error("BigIntegerUtil::stringToBigUnsigned: string recieved is not a valid number");
+			throw std::runtime_error("BigIntegerUtil::stringToBigUnsigned: string recieved is not a valid number");
 
 		switch (_str.front())
 		{
 		case '-':
-			throw runtime_error("BigIntegerUtil::stringToBigUnsigned: cannot convert a negative number to an unsigned data type");
+			throw std::runtime_error("BigIntegerUtil::stringToBigUnsigned: cannot convert a negative number to an unsigned data type");
 		case '+':
-			_str.erase(begin(_str));
+			_str.erase(std::begin(_str));
 			if (_str.empty())
-				throw runtime_error("BigIntegerUtil::stringToBigUnsigned: string recieved is not a valid number");
+				throw std::runtime_error("BigIntegerUtil::stringToBigUnsigned: string recieved is not a valid number");
 			break;
 		default:
 			break;
@@ -70,21 +374,21 @@ namespace BigNumber
 
 		if ((base == 0 || base == 8 || base == 16) && (_str.front() == '0' && _str.size() > 1))
 		{
-			_str.erase(begin(_str));
+			_str.erase(std::begin(_str));
 
 			if (_str.front() == 'x' || _str.front() == 'X')
 			{
-				_str.erase(begin(_str));
+				_str.erase(std::begin(_str));
 
 				if (!_str.empty())
 				{
 					if (base == 0)
 						base = 16;
 					else if (base == 8)
-						throw runtime_error("BigIntegerUtil::stringToBigUnsigned: invalid character found for specified base");
+						throw std::runtime_error("BigIntegerUtil::stringToBigUnsigned: invalid character found for specified base");
 				}
 				else
-					throw runtime_error("BigIntegerUtil::stringToBigUnsigned: string recieved is not a valid number");
+					throw std::runtime_error("BigIntegerUtil::stringToBigUnsigned: string recieved is not a valid number");
 			}
 			else if (base == 0)
 				base = 8;
@@ -93,159 +397,337 @@ namespace BigNumber
 		if (base == 0)
 			base = 10;
 
-		BigUnsigned data, add(1);
-
-		for (auto iter = rbegin(_str); iter != rend(_str); ++iter)
+		// turn the characters into digit values
+		for (auto &digit : _str)
 		{
-			if (base <= 10)
-			{
-				if (isdigit(*iter) && *iter < (char)base + '0')
-					data += add * (*iter - '0');
-				else
-					throw runtime_error("BigIntegerUtil::stringToBigUnsigned: invalid character found for specified base");
-			}
-			else
-			{
-				if (isdigit(*iter))
-					data += add * (*iter - '0');
-				else
-				{
-					if (islower(*iter))
-					{
-						if ((*iter - 'a') + 10 < (char)base)
-							data += add * ((*iter - 'a') + 10);
-						else
-							throw runtime_error("BigIntegerUtil::stringToBigUnsigned: invalid character found for specified base");
-					}
-					else if (isupper(*iter))
-					{
-						if ((*iter - 'A') + 10 < (char)base)
-							data += add * ((*iter - 'A') + 10);
-						else
-							throw runtime_error("BigIntegerUtil::stringToBigUnsigned: invalid character found for specified base");
-					}
-					else
-						throw runtime_error("BigIntegerUtil::stringToBigUnsigned: invalid character found for specified base");
-				}
-			}
+			const unsigned int value = digitValue(digit, base);
 
-			add *= base;
+			if (value == base)
+				throw std::runtime_error("BigIntegerUtil::stringToBigUnsigned: invalid character found for specified base");
+
+			digit = (char)value;
 		}
 
-		return move(data);
+		// the size is counted as the limbs the digits fill
+		BIGNUMBER_COUNT_OPERATION(FromString, (size_t)(_str.size() * std::log2(base)) / Kernels::limbBits + 1);
+		BIGNUMBER_TIME_ALGORITHM(BigInstrumentation::Algorithm::FromString);
+
+		if (const unsigned int bits = bitsPerDigit(base))
+			return readPowerOfTwo(_str, bits);
+
+		// work out every power that splitting the digits in half needs
+		Radix radix(base);
+
+		while ((radix.digits << radix.powers.size()) < _str.size())
+			radix.square();
+
+		return readDigits(_str.data(), _str.size(), radix);
 	}
 
 	/// converts a string to a BigInteger
-	BigInteger BigIntegerUtil::stringToBigInteger(string _str, unsigned int base)
+	BIGNUMBER_INLINE BigInteger BigIntegerUtil::stringToBigInteger(std::string _str, unsigned int base)
 	{
 		if (_str.empty())
-			throw runtime_error("BigIntegerUtil::stringToBigUnsigned: string recieved is not a valid number");
+			throw std::runtime_error("BigIntegerUtil::stringToBigUnsigned: string recieved is not a valid number");
 
 		BigInteger retVal; // return value
+		bool negative = false;
 
 		if (_str.front() == '-') // check for negative sign
 		{
-			_str.erase(begin(_str)); // remove negative sign
-			retVal.negative = true; // set negative to true
+			_str.erase(std::begin(_str)); // remove negative sign
+			negative = true;
 		}
 
-		retVal.data = stringToBigUnsigned(move(_str), base); // get the data
+		retVal.data = stringToBigUnsigned(std::move(_str), base); // get the data
+		retVal.negative = negative && retVal.data; // "-0" is zero, which is never negative
 
-		return move(retVal);
+		return std::move(retVal);
 	}
 
 	/// converts a BigUnsigned to a string
-	string BigIntegerUtil::bigUnsignedToString(BigUnsigned value, unsigned int base)
+	BIGNUMBER_INLINE std::string BigIntegerUtil::bigUnsignedToString(BigUnsigned value, unsigned int base)
 	{
 		if (base < 2 || base > 36)
-			throw out_of_range("BigIntegerUtil::bigUnsignedToString: invalid base number");
+			throw std::out_of_range("BigIntegerUtil::bigUnsignedToString: invalid base number");
 
-		string results;
+		if (!value)
+			return "0";
 
-		if (value)
-		{
-			unsigned int val;
+		BIGNUMBER_COUNT_OPERATION(ToString, value.pData->size());
+		BIGNUMBER_TIME_ALGORITHM(BigInstrumentation::Algorithm::ToString);
 
-			while (value > base)
-			{
-				val = (unsigned int)value.divideWithRemainder(base);
+		if (const unsigned int bits = bitsPerDigit(base))
+			return writePowerOfTwo(value, bits);
 
-				if (val < 10)
-					results.insert(begin(results), (char)val + '0');
-				else
-					results.insert(begin(results), char(val - 10) + 'a');
-			}
+		// find the smallest power that's bigger than value. the last one is only
+		// worked out when it's needed to tell if value is smaller than it
+		Radix radix(base);
+		const size_t size = value.pData->size();
+		size_t level = 0;
 
-			if (value)
-			{
-				val = (unsigned int)value;
+		while (radix.powers[level] <= value)
+		{
+			++level;
 
-				if (val < 10)
-					results.insert(begin(results), (char)val + '0');
-				else
-					results.insert(begin(results), char(val - 10) + 'a');
-			}
+			if (2 * radix.powers[level - 1].pData->size() - 2 >= size)
+				break; // the next power is too big to be less than or equal to value
+
+			radix.square();
 		}
-		else
-			results = "0";
 
-		return move(results);
+		std::string results(radix.digits << level, '0');
+		writeDigits(value, radix, level, &results[0]);
+
+		// remove the leading zeros
+		results.erase(0, results.find_first_not_of('0'));
+
+		return results;
 	}
 
 	/// converts a BigInteger to a string
-	string BigIntegerUtil::bigIntegerToString(const BigInteger &value, unsigned int base)
+	BIGNUMBER_INLINE std::string BigIntegerUtil::bigIntegerToString(const BigInteger &value, unsigned int base)
 	{
 		if (base < 2 || base > 36)
-			throw out_of_range("BigIntegerUtil::bigIntegerToString: invalid base number");
+			throw std::out_of_range("BigIntegerUtil::bigIntegerToString: invalid base number");
 
-		string results = bigUnsignedToString(value.data, base);
+		std::string results = bigUnsignedToString(value.data, base);
 
 		if (value.negative)
-			results.insert(begin(results), '-');
+			results.insert(std::begin(results), '-');
 
-		return move(results);
+		return std::move(results);
 	}
 
 	/// sets a BigUnsigned to zero
-	void BigIntegerUtil::clear(BigUnsigned &value)
+	BIGNUMBER_INLINE void BigIntegerUtil::clear(BigUnsigned &value)
 	{
 		if (value)
 			value.clearData();
 	}
 
 	/// sets a BigInteger to zero
-	void BigIntegerUtil::clear(BigInteger &value)
+	BIGNUMBER_INLINE void BigIntegerUtil::clear(BigInteger &value)
 	{
 		clear(value.data);
 		value.negative = false;
 	}
 
 	/// returns the absolute value of a BigInteger
-	BigInteger BigIntegerUtil::abs(const BigInteger &value)
+	BIGNUMBER_INLINE BigInteger BigIntegerUtil::abs(const BigInteger &value)
 	{
 		if (value.negative)
-			return move(-value);
+			return std::move(-value);
 		else
 			return value;
 	}
 
-	ostream &operator <<(ostream &os, const BigUnsigned &num)
+	// limbCount returns the number of limbs in a value
+	BIGNUMBER_INLINE size_t BigIntegerUtil::limbCount(const BigUnsigned &value)
+	{
+		return value ? value.pData->size() : 0;
+	}
+
+	// productRange multiplies count values (count > 0). sizes has the number of limbs
+	// before each value added together (count + 1 of them) so the values can be split
+	// where both halves have about the same number of limbs
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::productRange(const BigUnsigned *values, const size_t *sizes, size_t count)
+	{
+		if (count == 1)
+			return values[0];
+
+		const size_t total = sizes[count] - sizes[0];
+		size_t half = std::upper_bound(sizes + 1, sizes + count, sizes[0] + total / 2) - sizes;
+		half = std::min(std::max(half, (size_t)1), count - 1);
+
+		BigUnsigned low, high, retVal;
+
+		runBoth(total,
+			[&]() { low = productRange(values, sizes, half); },
+			[&]() { high = productRange(values + half, sizes + half, count - half); });
+
+		mul(retVal, low, high);
+		return retVal;
+	}
+
+	// sumRange adds count values (count > 0). sizes works the same as productRange.
+	// addition doesn't care about balance so the values are only split for threads
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::sumRange(const BigUnsigned *values, const size_t *sizes, size_t count)
+	{
+		const size_t total = sizes[count] - sizes[0];
+
+		if (count == 1 || total < BigThreadPool::parallelThreshold() || BigThreadPool::threadCount() <= 1)
+		{
+			BigUnsigned retVal;
+
+			for (size_t i = 0; i < count; ++i)
+				retVal += values[i];
+
+			return retVal;
+		}
+
+		const size_t half = count / 2;
+		BigUnsigned low, high;
+
+		runBoth(total,
+			[&]() { low = sumRange(values, sizes, half); },
+			[&]() { high = sumRange(values + half, sizes + half, count - half); });
+
+		return low += high;
+	}
+
+	/// returns the product of the values
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::productOf(const std::vector<BigUnsigned> &values)
+	{
+		if (values.empty())
+			return 1;
+
+		std::vector<size_t> sizes(1);
+
+		for (const auto &value : values)
+		{
+			if (!value)
+				return BigUnsigned(); // anything multiplied by zero is zero
+
+			sizes.push_back(sizes.back() + limbCount(value));
+		}
+
+		return productRange(values.data(), sizes.data(), values.size());
+	}
+
+	/// returns the product of the values
+	BIGNUMBER_INLINE BigInteger BigIntegerUtil::productOf(const std::vector<BigInteger> &values)
+	{
+		std::vector<BigUnsigned> magnitudes;
+		bool negative = false;
+
+		magnitudes.reserve(values.size());
+
+		for (const auto &value : values)
+		{
+			magnitudes.push_back(value.data);
+			negative ^= value.negative;
+		}
+
+		BigInteger retVal = toSigned(productOf(magnitudes));
+		retVal.negative = negative && retVal.data;
+		return retVal;
+	}
+
+	/// returns the sum of the values
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::sumOf(const std::vector<BigUnsigned> &values)
+	{
+		if (values.empty())
+			return BigUnsigned();
+
+		std::vector<size_t> sizes(1);
+
+		for (const auto &value : values)
+			sizes.push_back(sizes.back() + limbCount(value));
+
+		return sumRange(values.data(), sizes.data(), values.size());
+	}
+
+	/// returns the sum of the values
+	BIGNUMBER_INLINE BigInteger BigIntegerUtil::sumOf(const std::vector<BigInteger> &values)
+	{
+		// add the positive and negative values separately and then take one from the other
+		std::vector<BigUnsigned> positive, negative;
+
+		for (const auto &value : values)
+			(value.negative ? negative : positive).push_back(value.data);
+
+		return toSigned(sumOf(positive)) - toSigned(sumOf(negative));
+	}
+
+	/// returns n!
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::factorial(size_t n)
+	{
+		// the odd part of every factor is multiplied and the twos are put
+		// back at the end with a shift
+		Factors factors;
+		size_t twos = 0;
+
+		for (size_t i = 2; i <= n && i != 0; ++i)
+		{
+			size_t odd = i;
+
+			while ((odd & 1) == 0)
+			{
+				odd >>= 1;
+				++twos;
+			}
+
+			if (odd != 1)
+				factors.add(odd);
+		}
+
+		return productOf(factors.finish()) <<= twos;
+	}
+
+	/// returns n choose k
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::binomial(size_t n, size_t k)
+	{
+		if (k > n)
+			return BigUnsigned();
+
+		k = std::min(k, n - k);
+
+		// the power of every prime in n! / (k! (n - k)!) comes from counting how many
+		// of the numbers up to n, k and n - k it divides (Legendre's formula). this
+		// way nothing has to be divided
+		Factors factors;
+
+		for (size_t prime : primesUpTo(n))
+		{
+			size_t power = 1;
+
+			for (size_t p = prime; ; p *= prime)
+			{
+				const size_t times = n / p - k / p - (n - k) / p;
+
+				for (size_t i = 0; i < times; ++i)
+					power *= prime; // the power can't be bigger than n
+
+				if (p > n / prime)
+					break;
+			}
+
+			if (power != 1)
+				factors.add(power);
+		}
+
+		return productOf(factors.finish());
+	}
+
+	/// returns the product of the primes up to n
+	BIGNUMBER_INLINE BigUnsigned BigIntegerUtil::primorial(size_t n)
+	{
+		Factors factors;
+
+		for (size_t prime : primesUpTo(n))
+			factors.add(prime);
+
+		return productOf(factors.finish());
+	}
+
+	BIGNUMBER_INLINE std::ostream &operator <<(std::ostream &os, const BigUnsigned &num)
 	{
-		if ((os.flags() & ios_base::showpos) != 0)
+		if ((os.flags() & std::ios_base::showpos) != 0)
 			os << "+";
 
-		if ((os.flags() & ios_base::hex) != 0)
+		if ((os.flags() & std::ios_base::hex) != 0)
 		{
-			if ((os.flags() & ios_base::showbase) != 0)
+			if ((os.flags() & std::ios_base::showbase) != 0)
 				os << "0x";
 
 			os << BigIntegerUtil::bigUnsignedToString(num, 16);
 		}
-		else if ((os.flags() & ios_base::oct) != 0)
+		else if ((os.flags() & std::ios_base::oct) != 0)
 		{
 			if (num)
 			{
-				if ((os.flags() & ios_base::showbase) != 0)
+				if ((os.flags() & std::ios_base::showbase) != 0)
 					os << "0";
 
 				os << BigIntegerUtil::bigUnsignedToString(num, 8);
@@ -259,23 +741,23 @@ namespace BigNumber
 		return os;
 	}
 
-	ostream &operator <<(ostream &os, const BigInteger &num)
+	BIGNUMBER_INLINE std::ostream &operator <<(std::ostream &os, const BigInteger &num)
 	{
-		if (num >= 0 && (os.flags() & ios_base::showpos) != 0)
+		if (num >= 0 && (os.flags() & std::ios_base::showpos) != 0)
 			os << "+";
 
-		if ((os.flags() & ios_base::hex) != 0)
+		if ((os.flags() & std::ios_base::hex) != 0)
 		{
-			if ((os.flags() & ios_base::showbase) != 0)
+			if ((os.flags() & std::ios_base::showbase) != 0)
 				os << "0x";
 
 			os << BigIntegerUtil::bigIntegerToString(num, 16);
 		}
-		else if ((os.flags() & ios_base::oct) != 0)
+		else if ((os.flags() & std::ios_base::oct) != 0)
 		{
 			if (num)
 			{
-				if ((os.flags() & ios_base::showbase) != 0)
+				if ((os.flags() & std::ios_base::showbase) != 0)
 					os << "0";
 
 				os << BigIntegerUtil::bigIntegerToString(num, 8);
@@ -289,9 +771,9 @@ namespace BigNumber
 		return os;
 	}
 
-	istream &operator >>(istream &is, BigUnsigned &num)
+	BIGNUMBER_INLINE std::istream &operator >>(std::istream &is, BigUnsigned &num)
 	{
-		string text;
+		std::string text;
 
 		is >> text;
 
@@ -300,9 +782,9 @@ namespace BigNumber
 		return is;
 	}
 
-	istream &operator >>(istream &is, BigInteger &num)
+	BIGNUMBER_INLINE std::istream &operator >>(std::istream &is, BigInteger &num)
 	{
-		string text;
+		std::string text;
 
 		is >> text;
 
@@ -26,13 +26,27 @@ Email address: weston925@gmail.com
 #ifndef BIGINTUTILITIES_H
 #define BIGINTUTILITIES_H
 
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGINTUTILITIES_H_SOURCES
+#endif
+
 #include "BigInteger.h"
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <sstream>
+#include <type_traits>
+#include <vector>
 
 namespace BigNumber
 {
+	// template alias for the type the range functions return (BigInteger when
+	// the values can be negative and BigUnsigned when they can't)
+	template <typename Iterator, typename Value = typename std::decay<typename std::iterator_traits<Iterator>::value_type>::type>
+	using RangeResult = typename std::conditional<std::is_same<Value, BigInteger>::value || std::is_signed<Value>::value, BigInteger, BigUnsigned>::type;
+
 	class BigIntegerUtil
 	{
 	public:
@@ -54,8 +68,53 @@ namespace BigNumber
 
 		/// Get the absolute value of a BigInteger
 		static BigInteger abs(const BigInteger &);
+
+		/// Product and sum of many numbers (one and zero when there aren't any). the numbers are
+		/// put together as a balanced tree so the multiplications are about the same size, and
+		/// the branches run on BigThreadPool when they're over the parallel threshold
+		static BigUnsigned productOf(const std::vector<BigUnsigned> &);
+		static BigInteger productOf(const std::vector<BigInteger> &);
+		static BigUnsigned sumOf(const std::vector<BigUnsigned> &);
+		static BigInteger sumOf(const std::vector<BigInteger> &);
+
+		template <typename Iterator> static RangeResult<Iterator> productOf(Iterator, Iterator);
+		template <typename Iterator> static RangeResult<Iterator> sumOf(Iterator, Iterator);
+
+		/// Factorial (n!), binomial coefficient (n choose k) and primorial (product of the primes up to n)
+		static BigUnsigned factorial(size_t);
+		static BigUnsigned binomial(size_t, size_t);
+		static BigUnsigned primorial(size_t);
+
+	private:
+		typedef BigUnsigned::colType colType; // collection type
+		struct Radix; // a base and the powers of it used by the conversions
+
+		/// Helper functions for the conversions
+		static void writeDigits(const BigUnsigned &, const Radix &, size_t, char *);
+		static BigUnsigned readDigits(const char *, size_t, const Radix &);
+		static std::string writePowerOfTwo(const BigUnsigned &, unsigned int);
+		static BigUnsigned readPowerOfTwo(const std::string &, unsigned int);
+
+		/// Helper functions for the products and sums
+		static size_t limbCount(const BigUnsigned &);
+		static BigUnsigned productRange(const BigUnsigned *, const size_t *, size_t);
+		static BigUnsigned sumRange(const BigUnsigned *, const size_t *, size_t);
 	};
 
+	/// Product of a range of numbers
+	template <typename Iterator>
+	RangeResult<Iterator> BigIntegerUtil::productOf(Iterator first, Iterator last)
+	{
+		return productOf(std::vector<RangeResult<Iterator>>(first, last));
+	}
+
+	/// Sum of a range of numbers
+	template <typename Iterator>
+	RangeResult<Iterator> BigIntegerUtil::sumOf(Iterator first, Iterator last)
+	{
+		return sumOf(std::vector<RangeResult<Iterator>>(first, last));
+	}
+
 	/// ostream and istream operator overloads
 	std::ostream &operator <<(std::ostream &, const BigUnsigned &);
 	std::ostream &operator <<(std::ostream &, const BigInteger &);
@@ -63,4 +122,8 @@ namespace BigNumber
 	std::istream &operator >>(std::istream &, BigInteger &);
 } // namespace BigNumber
 
+#ifdef BIGINTUTILITIES_H_SOURCES
+#include "BigSources.h"
+#endif
+
 #endif // BIGINTUTILITIES_H
@@ -0,0 +1,1580 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#include "BigKernels.h"
+#include "BigInstrumentation.h"
+#include "BigThreadPool.h"
+#include "BigTuning.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+
+// pick the double width and carry operations the compiler can do best. when
+// none of them are there the kernels fall back to plain C++
+#ifdef __has_builtin
+#define BIGNUMBER_HAS_BUILTIN(x) __has_builtin(x)
+#else
+#define BIGNUMBER_HAS_BUILTIN(x) 0
+#endif
+
+#if BIGNUMBER_LIMB_BITS == 32
+#define BIGNUMBER_WIDE_LIMB // a 64-bit type holds two limbs
+#elif defined(__SIZEOF_INT128__)
+#define BIGNUMBER_INT128 // unsigned __int128 holds two limbs
+#endif
+
+#if BIGNUMBER_LIMB_BITS == 64 && BIGNUMBER_HAS_BUILTIN(__builtin_addcll) && BIGNUMBER_HAS_BUILTIN(__builtin_subcll)
+#define BIGNUMBER_BUILTIN_CARRY // __builtin_addcll and __builtin_subcll (Clang and newer GCC)
+#elif BIGNUMBER_LIMB_BITS == 64 && (defined(_M_X64) || defined(__x86_64__))
+#define BIGNUMBER_INTRINSIC_CARRY // _addcarry_u64 and _subborrow_u64
+#endif
+
+// the assembly kernels are written for GCC and Clang on x86-64. defining
+// BIGNUMBER_NO_ASM leaves them out
+#if BIGNUMBER_LIMB_BITS == 64 && defined(__x86_64__) && defined(__GNUC__) && !defined(BIGNUMBER_NO_ASM)
+#define BIGNUMBER_X86_64_ASM
+#endif
+
+// the vector kernels use intrinsics so they work with MSVC too. defining
+// BIGNUMBER_NO_SIMD leaves them out
+#if BIGNUMBER_LIMB_BITS == 64 && (defined(__x86_64__) || defined(_M_X64)) && !defined(BIGNUMBER_NO_SIMD)
+#define BIGNUMBER_X86_64_SIMD
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#define BIGNUMBER_TARGET(x) __attribute__((target(x))) // lets a function use instructions the rest of the file can't
+#else
+#define BIGNUMBER_TARGET(x)
+#endif
+#endif
+
+namespace BigNumber
+{
+	namespace Kernels
+	{
+		namespace detail
+		{
+			BIGNUMBER_INLINE const unsigned int halfBits = limbBits / 2; // number of bits in half a limb
+			BIGNUMBER_INLINE const limb halfMask = ((limb)1 << halfBits) - 1; // mask for the lower half of a limb
+
+#if defined(BIGNUMBER_WIDE_LIMB)
+			typedef std::uint64_t wideLimb; // double width type
+#elif defined(BIGNUMBER_INT128)
+			typedef unsigned __int128 wideLimb; // double width type
+#endif
+
+			// returns the number of leading zero bits (value can't be zero)
+			inline unsigned int leadingZeroBits(limb value)
+			{
+#if defined(__GNUC__) && BIGNUMBER_LIMB_BITS == 64
+				return (unsigned int)__builtin_clzll(value);
+#elif defined(__GNUC__)
+				return (unsigned int)__builtin_clz(value);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64)) && BIGNUMBER_LIMB_BITS == 64
+				unsigned long index;
+				_BitScanReverse64(&index, value);
+				return (unsigned int)(limbBits - 1 - index);
+#elif defined(_MSC_VER) && BIGNUMBER_LIMB_BITS == 32
+				unsigned long index;
+				_BitScanReverse(&index, value);
+				return (unsigned int)(limbBits - 1 - index);
+#else
+				unsigned int count = 0;
+
+				while ((value & ((limb)1 << (limbBits - 1))) == 0)
+				{
+					value <<= 1;
+					++count;
+				}
+
+				return count;
+#endif
+			}
+
+			// returns the number of trailing zero bits (value can't be zero)
+			inline unsigned int trailingZeroBits(limb value)
+			{
+#if defined(__GNUC__) && BIGNUMBER_LIMB_BITS == 64
+				return (unsigned int)__builtin_ctzll(value);
+#elif defined(__GNUC__)
+				return (unsigned int)__builtin_ctz(value);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64)) && BIGNUMBER_LIMB_BITS == 64
+				unsigned long index;
+				_BitScanForward64(&index, value);
+				return (unsigned int)index;
+#elif defined(_MSC_VER) && BIGNUMBER_LIMB_BITS == 32
+				unsigned long index;
+				_BitScanForward(&index, value);
+				return (unsigned int)index;
+#else
+				unsigned int count = 0;
+
+				while ((value & 1) == 0)
+				{
+					value >>= 1;
+					++count;
+				}
+
+				return count;
+#endif
+			}
+
+			// returns the number of set bits
+			inline unsigned int setBits(limb value)
+			{
+#if defined(__GNUC__) && BIGNUMBER_LIMB_BITS == 64
+				return (unsigned int)__builtin_popcountll(value);
+#elif defined(__GNUC__)
+				return (unsigned int)__builtin_popcount(value);
+#else
+				// add up the bits in pairs, then nibbles, then bytes and
+				// let the multiplication add the bytes into the top one
+				const limb ones = ~(limb)0;
+				value -= (value >> 1) & (ones / 3);
+				value = (value & (ones / 5)) + ((value >> 2) & (ones / 5));
+				value = (value + (value >> 4)) & (ones / 17);
+				return (unsigned int)((value * (ones / 255)) >> (limbBits - 8));
+#endif
+			}
+
+			// addCarry returns a + b + carry and sets carry to the carry out (carry is 0 or 1)
+			inline limb addCarry(limb a, limb b, unsigned char &carry)
+			{
+#if defined(BIGNUMBER_BUILTIN_CARRY)
+				unsigned long long carryOut;
+				const limb sum = __builtin_addcll(a, b, carry, &carryOut);
+				carry = (unsigned char)carryOut;
+				return sum;
+#elif defined(BIGNUMBER_INTRINSIC_CARRY)
+				unsigned long long sum;
+				carry = _addcarry_u64(carry, a, b, &sum);
+				return sum;
+#elif defined(BIGNUMBER_WIDE_LIMB) || defined(BIGNUMBER_INT128)
+				const wideLimb sum = (wideLimb)a + b + carry;
+				carry = (unsigned char)(sum >> limbBits);
+				return (limb)sum;
+#else
+				limb sum = a + carry;
+				carry = sum < carry ? 1 : 0;
+				sum += b;
+				carry += sum < b ? 1 : 0;
+				return sum;
+#endif
+			}
+
+			// subBorrow returns a - b - borrow and sets borrow to the borrow out (borrow is 0 or 1)
+			inline limb subBorrow(limb a, limb b, unsigned char &borrow)
+			{
+#if defined(BIGNUMBER_BUILTIN_CARRY)
+				unsigned long long borrowOut;
+				const limb difference = __builtin_subcll(a, b, borrow, &borrowOut);
+				borrow = (unsigned char)borrowOut;
+				return difference;
+#elif defined(BIGNUMBER_INTRINSIC_CARRY)
+				unsigned long long difference;
+				borrow = _subborrow_u64(borrow, a, b, &difference);
+				return difference;
+#else
+				const limb difference = a - b;
+				const unsigned char borrowOut = (a < b ? 1 : 0) + (difference < borrow ? 1 : 0);
+				const limb retVal = difference - borrow;
+				borrow = borrowOut;
+				return retVal;
+#endif
+			}
+		} // namespace detail
+
+		using namespace detail;
+
+		// mulWide uses the double width type or intrinsic when there is one and
+		// otherwise multiplies two limbs by splitting them into halves
+		BIGNUMBER_INLINE limb mulWide(limb a, limb b, limb &high)
+		{
+#if defined(BIGNUMBER_WIDE_LIMB) || defined(BIGNUMBER_INT128)
+			const wideLimb product = (wideLimb)a * b;
+			high = (limb)(product >> limbBits);
+			return (limb)product;
+#elif defined(_MSC_VER) && defined(_M_X64)
+			unsigned long long productHigh;
+			const limb retVal = _umul128(a, b, &productHigh);
+			high = productHigh;
+			return retVal;
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+			high = __umulh(a, b);
+			return a * b;
+#else
+			const limb aLow = a & halfMask, aHigh = a >> halfBits;
+			const limb bLow = b & halfMask, bHigh = b >> halfBits;
+
+			const limb lowLow = aLow * bLow;
+			const limb lowHigh = aLow * bHigh;
+			const limb highLow = aHigh * bLow;
+			const limb highHigh = aHigh * bHigh;
+
+			// this can't overflow since each part is smaller than half a limb
+			const limb middle = (lowLow >> halfBits) + (lowHigh & halfMask) + (highLow & halfMask);
+
+			high = highHigh + (lowHigh >> halfBits) + (highLow >> halfBits) + (middle >> halfBits);
+			return (middle << halfBits) | (lowLow & halfMask);
+#endif
+		}
+
+		// divWide uses the hardware division when there is one. otherwise it
+		// divides a two limb number by a limb using two half limb steps (this
+		// is the divlu algorithm from Hacker's Delight)
+		BIGNUMBER_INLINE limb divWide(limb high, limb low, limb d, limb &remainder)
+		{
+#if defined(BIGNUMBER_WIDE_LIMB)
+			const wideLimb dividend = ((wideLimb)high << limbBits) | low;
+			remainder = (limb)(dividend % d);
+			return (limb)(dividend / d);
+#elif BIGNUMBER_LIMB_BITS == 64 && defined(__x86_64__) && defined(__GNUC__)
+			// high < d so the quotient fits and divq can't fault
+			limb quotient;
+			__asm__("divq %4" : "=a"(quotient), "=d"(remainder) : "a"(low), "d"(high), "rm"(d));
+			return quotient;
+#elif defined(_MSC_VER) && defined(_M_X64) && _MSC_VER >= 1920
+			unsigned long long rest;
+			const limb quotient = _udiv128(high, low, d, &rest);
+			remainder = rest;
+			return quotient;
+#else
+			const limb base = (limb)1 << halfBits;
+
+			// normalize the divisor so its top bit is set
+			const unsigned int shift = leadingZeroBits(d);
+			d <<= shift;
+
+			const limb divisorHigh = d >> halfBits, divisorLow = d & halfMask;
+			const limb top = shift == 0 ? high : (high << shift) | (low >> (limbBits - shift));
+			const limb bottom = low << shift;
+			const limb bottomHigh = bottom >> halfBits, bottomLow = bottom & halfMask;
+
+			// get the upper half of the quotient
+			limb quotientHigh = top / divisorHigh;
+			limb rest = top - quotientHigh * divisorHigh;
+
+			while (quotientHigh >= base || quotientHigh * divisorLow > ((rest << halfBits) | bottomHigh))
+			{
+				--quotientHigh;
+				rest += divisorHigh;
+
+				if (rest >= base)
+					break;
+			}
+
+			const limb middle = (top << halfBits) + bottomHigh - quotientHigh * d;
+
+			// get the lower half of the quotient
+			limb quotientLow = middle / divisorHigh;
+			rest = middle - quotientLow * divisorHigh;
+
+			while (quotientLow >= base || quotientLow * divisorLow > ((rest << halfBits) | bottomLow))
+			{
+				--quotientLow;
+				rest += divisorHigh;
+
+				if (rest >= base)
+					break;
+			}
+
+			remainder = ((middle << halfBits) + bottomLow - quotientLow * d) >> shift;
+			return (quotientHigh << halfBits) | quotientLow;
+#endif
+		}
+
+		namespace detail
+		{
+			// addNPortable adds two arrays with the same size
+			BIGNUMBER_INLINE limb addNPortable(limb *r, const limb *a, const limb *b, size_t size)
+			{
+				unsigned char carry = 0;
+
+				for (size_t i = 0; i < size; ++i)
+					r[i] = addCarry(a[i], b[i], carry);
+
+				return carry;
+			}
+
+			// subNPortable subtracts two arrays with the same size
+			BIGNUMBER_INLINE limb subNPortable(limb *r, const limb *a, const limb *b, size_t size)
+			{
+				unsigned char borrow = 0;
+
+				for (size_t i = 0; i < size; ++i)
+					r[i] = subBorrow(a[i], b[i], borrow);
+
+				return borrow;
+			}
+
+			// mul1Portable multiplies an array by a single limb
+			BIGNUMBER_INLINE limb mul1Portable(limb *r, const limb *a, size_t size, limb b)
+			{
+				limb carry = 0, high;
+
+				for (size_t i = 0; i < size; ++i)
+				{
+					unsigned char lowCarry = 0;
+					const limb low = mulWide(a[i], b, high);
+					r[i] = addCarry(low, carry, lowCarry);
+					carry = high + lowCarry; // can't overflow since high is at most the limb's max minus one
+				}
+
+				return carry;
+			}
+
+			// addmul1Portable multiplies an array by a single limb and adds it to the output
+			BIGNUMBER_INLINE limb addmul1Portable(limb *r, const limb *a, size_t size, limb b)
+			{
+				limb carry = 0, high;
+
+				for (size_t i = 0; i < size; ++i)
+				{
+					unsigned char lowCarry = 0, sumCarry = 0;
+					const limb low = mulWide(a[i], b, high);
+					r[i] = addCarry(r[i], addCarry(low, carry, lowCarry), sumCarry);
+					carry = high + lowCarry + sumCarry; // the product plus two limbs always fits in two limbs
+				}
+
+				return carry;
+			}
+
+			// submul1Portable multiplies an array by a single limb and subtracts it from the output
+			BIGNUMBER_INLINE limb submul1Portable(limb *r, const limb *a, size_t size, limb b)
+			{
+				limb borrow = 0, high;
+
+				for (size_t i = 0; i < size; ++i)
+				{
+					unsigned char lowCarry = 0, difBorrow = 0;
+					const limb low = mulWide(a[i], b, high);
+					r[i] = subBorrow(r[i], addCarry(low, borrow, lowCarry), difBorrow);
+					borrow = high + lowCarry + difBorrow;
+				}
+
+				return borrow;
+			}
+
+			// lshiftPortable shifts from the most significant limb down
+			BIGNUMBER_INLINE limb lshiftPortable(limb *r, const limb *a, size_t size, unsigned int count)
+			{
+				limb high = a[size - 1];
+				const limb retVal = high >> (limbBits - count);
+
+				for (size_t i = size - 1; i > 0; --i)
+				{
+					const limb low = a[i - 1];
+					r[i] = (high << count) | (low >> (limbBits - count));
+					high = low;
+				}
+
+				r[0] = high << count;
+				return retVal;
+			}
+
+			// rshiftPortable shifts from the least significant limb up
+			BIGNUMBER_INLINE limb rshiftPortable(limb *r, const limb *a, size_t size, unsigned int count)
+			{
+				limb low = a[0];
+				const limb retVal = low << (limbBits - count);
+
+				for (size_t i = 0; i + 1 < size; ++i)
+				{
+					const limb high = a[i + 1];
+					r[i] = (low >> count) | (high << (limbBits - count));
+					low = high;
+				}
+
+				r[size - 1] = low >> count;
+				return retVal;
+			}
+
+#ifdef BIGNUMBER_X86_64_ASM
+			// The assembly kernels need at least one limb. The add, subtract and
+			// shift kernels only use instructions every x86-64 cpu has. The multiply
+			// kernels use mulx (BMI2) and keep two carry chains going at the same
+			// time with adcx and adox (ADX), so they are only used when cpuid says
+			// the cpu has both. The loops that need both flags count with lea and
+			// jrcxz since those don't change any flags.
+
+			// addNAsm adds four limbs per loop after doing the extra ones
+			BIGNUMBER_INLINE limb addNAsm(limb *r, const limb *a, const limb *b, size_t size)
+			{
+				limb carry, temp;
+				size_t extra;
+
+				__asm__ volatile(
+					"mov %[count], %[extra]\n\t"
+					"and $3, %[extra]\n\t"
+					"shr $2, %[count]\n\t"
+					"test %[extra], %[extra]\n\t" // also clears the carry
+					"jz 2f\n"
+					"1:\n\t"
+					"mov (%[a]), %[temp]\n\t"
+					"adc (%[b]), %[temp]\n\t"
+					"mov %[temp], (%[r])\n\t"
+					"lea 8(%[a]), %[a]\n\t"
+					"lea 8(%[b]), %[b]\n\t"
+					"lea 8(%[r]), %[r]\n\t"
+					"dec %[extra]\n\t"
+					"jnz 1b\n"
+					"2:\n\t"
+					"jrcxz 4f\n"
+					"3:\n\t"
+					"mov (%[a]), %[temp]\n\t"
+					"adc (%[b]), %[temp]\n\t"
+					"mov %[temp], (%[r])\n\t"
+					"mov 8(%[a]), %[temp]\n\t"
+					"adc 8(%[b]), %[temp]\n\t"
+					"mov %[temp], 8(%[r])\n\t"
+					"mov 16(%[a]), %[temp]\n\t"
+					"adc 16(%[b]), %[temp]\n\t"
+					"mov %[temp], 16(%[r])\n\t"
+					"mov 24(%[a]), %[temp]\n\t"
+					"adc 24(%[b]), %[temp]\n\t"
+					"mov %[temp], 24(%[r])\n\t"
+					"lea 32(%[a]), %[a]\n\t"
+					"lea 32(%[b]), %[b]\n\t"
+					"lea 32(%[r]), %[r]\n\t"
+					"dec %[count]\n\t"
+					"jnz 3b\n"
+					"4:\n\t"
+					"mov $0, %[carry]\n\t"
+					"adc $0, %[carry]"
+					: [carry] "=&r"(carry), [temp] "=&r"(temp), [extra] "=&r"(extra),
+					  [r] "+r"(r), [a] "+r"(a), [b] "+r"(b), [count] "+c"(size)
+					:
+					: "cc", "memory");
+
+				return carry;
+			}
+
+			// subNAsm subtracts four limbs per loop after doing the extra ones
+			BIGNUMBER_INLINE limb subNAsm(limb *r, const limb *a, const limb *b, size_t size)
+			{
+				limb borrow, temp;
+				size_t extra;
+
+				__asm__ volatile(
+					"mov %[count], %[extra]\n\t"
+					"and $3, %[extra]\n\t"
+					"shr $2, %[count]\n\t"
+					"test %[extra], %[extra]\n\t" // also clears the borrow
+					"jz 2f\n"
+					"1:\n\t"
+					"mov (%[a]), %[temp]\n\t"
+					"sbb (%[b]), %[temp]\n\t"
+					"mov %[temp], (%[r])\n\t"
+					"lea 8(%[a]), %[a]\n\t"
+					"lea 8(%[b]), %[b]\n\t"
+					"lea 8(%[r]), %[r]\n\t"
+					"dec %[extra]\n\t"
+					"jnz 1b\n"
+					"2:\n\t"
+					"jrcxz 4f\n"
+					"3:\n\t"
+					"mov (%[a]), %[temp]\n\t"
+					"sbb (%[b]), %[temp]\n\t"
+					"mov %[temp], (%[r])\n\t"
+					"mov 8(%[a]), %[temp]\n\t"
+					"sbb 8(%[b]), %[temp]\n\t"
+					"mov %[temp], 8(%[r])\n\t"
+					"mov 16(%[a]), %[temp]\n\t"
+					"sbb 16(%[b]), %[temp]\n\t"
+					"mov %[temp], 16(%[r])\n\t"
+					"mov 24(%[a]), %[temp]\n\t"
+					"sbb 24(%[b]), %[temp]\n\t"
+					"mov %[temp], 24(%[r])\n\t"
+					"lea 32(%[a]), %[a]\n\t"
+					"lea 32(%[b]), %[b]\n\t"
+					"lea 32(%[r]), %[r]\n\t"
+					"dec %[count]\n\t"
+					"jnz 3b\n"
+					"4:\n\t"
+					"mov $0, %[borrow]\n\t"
+					"adc $0, %[borrow]"
+					: [borrow] "=&r"(borrow), [temp] "=&r"(temp), [extra] "=&r"(extra),
+					  [r] "+r"(r), [a] "+r"(a), [b] "+r"(b), [count] "+c"(size)
+					:
+					: "cc", "memory");
+
+				return borrow;
+			}
+
+			// mul1Asm multiplies with mulx and carries with adcx
+			BIGNUMBER_INLINE limb mul1Asm(limb *r, const limb *a, size_t size, limb b)
+			{
+				limb carry, low, high, zero;
+
+				__asm__ volatile(
+					"xor %k[zero], %k[zero]\n\t"
+					"xor %k[carry], %k[carry]\n" // also clears the carry flag
+					"1:\n\t"
+					"mulx (%[a]), %[low], %[high]\n\t"
+					"adcx %[carry], %[low]\n\t"
+					"mov %[low], (%[r])\n\t"
+					"mov %[high], %[carry]\n\t"
+					"lea 8(%[a]), %[a]\n\t"
+					"lea 8(%[r]), %[r]\n\t"
+					"dec %[count]\n\t" // dec doesn't change the carry flag
+					"jnz 1b\n\t"
+					"adcx %[zero], %[carry]"
+					: [carry] "=&r"(carry), [low] "=&r"(low), [high] "=&r"(high), [zero] "=&r"(zero),
+					  [r] "+r"(r), [a] "+r"(a), [count] "+r"(size)
+					: "d"(b)
+					: "cc", "memory");
+
+				return carry;
+			}
+
+			// addmul1Asm adds the previous high limb with the carry flag (adcx) and
+			// the output with the overflow flag (adox) so both chains run together
+			BIGNUMBER_INLINE limb addmul1Asm(limb *r, const limb *a, size_t size, limb b)
+			{
+				limb carry, low, high, zero;
+
+				__asm__ volatile(
+					"xor %k[zero], %k[zero]\n\t"
+					"xor %k[carry], %k[carry]\n" // also clears both flags
+					"1:\n\t"
+					"mulx (%[a]), %[low], %[high]\n\t"
+					"adcx %[carry], %[low]\n\t"
+					"adox (%[r]), %[low]\n\t"
+					"mov %[low], (%[r])\n\t"
+					"mov %[high], %[carry]\n\t"
+					"lea 8(%[a]), %[a]\n\t"
+					"lea 8(%[r]), %[r]\n\t"
+					"lea -1(%[count]), %[count]\n\t"
+					"jrcxz 2f\n\t"
+					"jmp 1b\n"
+					"2:\n\t"
+					"adcx %[zero], %[carry]\n\t"
+					"adox %[zero], %[carry]"
+					: [carry] "=&r"(carry), [low] "=&r"(low), [high] "=&r"(high), [zero] "=&r"(zero),
+					  [r] "+r"(r), [a] "+r"(a), [count] "+c"(size)
+					: "d"(b)
+					: "cc", "memory");
+
+				return carry;
+			}
+
+			// submul1Asm adds the previous high limb with the overflow flag (adox) and
+			// subtracts from the output by adding the NOT with the carry flag (adcx).
+			// the carry flag starts set and ends up as the opposite of the borrow
+			BIGNUMBER_INLINE limb submul1Asm(limb *r, const limb *a, size_t size, limb b)
+			{
+				limb borrow, low, high, zero;
+
+				__asm__ volatile(
+					"xor %k[zero], %k[zero]\n\t"
+					"xor %k[borrow], %k[borrow]\n\t" // also clears both flags
+					"stc\n"
+					"1:\n\t"
+					"mulx (%[a]), %[low], %[high]\n\t"
+					"adox %[borrow], %[low]\n\t"
+					"not %[low]\n\t"
+					"adcx (%[r]), %[low]\n\t"
+					"mov %[low], (%[r])\n\t"
+					"mov %[high], %[borrow]\n\t"
+					"lea 8(%[a]), %[a]\n\t"
+					"lea 8(%[r]), %[r]\n\t"
+					"lea -1(%[count]), %[count]\n\t"
+					"jrcxz 2f\n\t"
+					"jmp 1b\n"
+					"2:\n\t"
+					"adox %[zero], %[borrow]\n\t"
+					"cmc\n\t"
+					"adcx %[zero], %[borrow]"
+					: [borrow] "=&r"(borrow), [low] "=&r"(low), [high] "=&r"(high), [zero] "=&r"(zero),
+					  [r] "+r"(r), [a] "+r"(a), [count] "+c"(size)
+					: "d"(b)
+					: "cc", "memory");
+
+				return borrow;
+			}
+
+			// lshiftAsm uses shld from the most significant limb down
+			BIGNUMBER_INLINE limb lshiftAsm(limb *r, const limb *a, size_t size, unsigned int count)
+			{
+				const limb *source = a + size - 1;
+				limb *destination = r + size - 1;
+				limb retVal, high, low;
+				size_t remaining = size - 1;
+
+				__asm__ volatile(
+					"mov (%[source]), %[high]\n\t"
+					"xor %k[retVal], %k[retVal]\n\t"
+					"shld %%cl, %[high], %[retVal]\n\t"
+					"test %[remaining], %[remaining]\n\t"
+					"jz 2f\n"
+					"1:\n\t"
+					"mov -8(%[source]), %[low]\n\t"
+					"shld %%cl, %[low], %[high]\n\t"
+					"mov %[high], (%[destination])\n\t"
+					"mov %[low], %[high]\n\t"
+					"lea -8(%[source]), %[source]\n\t"
+					"lea -8(%[destination]), %[destination]\n\t"
+					"dec %[remaining]\n\t"
+					"jnz 1b\n"
+					"2:\n\t"
+					"shl %%cl, %[high]\n\t"
+					"mov %[high], (%[destination])"
+					: [retVal] "=&r"(retVal), [high] "=&r"(high), [low] "=&r"(low),
+					  [source] "+r"(source), [destination] "+r"(destination), [remaining] "+r"(remaining)
+					: "c"(count)
+					: "cc", "memory");
+
+				return retVal;
+			}
+
+			// rshiftAsm uses shrd from the least significant limb up
+			BIGNUMBER_INLINE limb rshiftAsm(limb *r, const limb *a, size_t size, unsigned int count)
+			{
+				limb retVal, high, low;
+				size_t remaining = size - 1;
+
+				__asm__ volatile(
+					"mov (%[source]), %[low]\n\t"
+					"xor %k[retVal], %k[retVal]\n\t"
+					"shrd %%cl, %[low], %[retVal]\n\t"
+					"test %[remaining], %[remaining]\n\t"
+					"jz 2f\n"
+					"1:\n\t"
+					"mov 8(%[source]), %[high]\n\t"
+					"shrd %%cl, %[high], %[low]\n\t"
+					"mov %[low], (%[destination])\n\t"
+					"mov %[high], %[low]\n\t"
+					"lea 8(%[source]), %[source]\n\t"
+					"lea 8(%[destination]), %[destination]\n\t"
+					"dec %[remaining]\n\t"
+					"jnz 1b\n"
+					"2:\n\t"
+					"shr %%cl, %[low]\n\t"
+					"mov %[low], (%[destination])"
+					: [retVal] "=&r"(retVal), [high] "=&r"(high), [low] "=&r"(low),
+					  [source] "+r"(a), [destination] "+r"(r), [remaining] "+r"(remaining)
+					: "c"(count)
+					: "cc", "memory");
+
+				return retVal;
+			}
+
+			// checks if the cpu has mulx (BMI2) and adcx/adox (ADX)
+			BIGNUMBER_INLINE bool hasMulxAndAdx()
+			{
+				unsigned int eax, ebx, ecx, edx;
+
+				if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+					return false;
+
+				return (ebx & (1u << 8)) != 0 && (ebx & (1u << 19)) != 0;
+			}
+#endif
+
+			// the bitwise operations. they all use the same signature so they can go
+			// in the dispatch table (NOT ignores the second input)
+			enum class Bitwise { And, Or, Xor, Not };
+
+			// bitwiseItem does the operation on a single limb
+			template <Bitwise Operation>
+			inline limb bitwiseItem(limb a, limb b)
+			{
+				switch (Operation)
+				{
+				case Bitwise::And:
+					return a & b;
+				case Bitwise::Or:
+					return a | b;
+				case Bitwise::Xor:
+					return a ^ b;
+				default:
+					return ~a;
+				}
+			}
+
+			// bitwisePortable does the operation one limb at a time
+			template <Bitwise Operation>
+			void bitwisePortable(limb *r, const limb *a, const limb *b, size_t size)
+			{
+				for (size_t i = 0; i < size; ++i)
+					r[i] = bitwiseItem<Operation>(a[i], Operation == Bitwise::Not ? 0 : b[i]);
+			}
+
+			// popcountPortable counts the bits one limb at a time
+			BIGNUMBER_INLINE size_t popcountPortable(const limb *a, size_t size)
+			{
+				size_t count = 0;
+
+				for (size_t i = 0; i < size; ++i)
+					count += setBits(a[i]);
+
+				return count;
+			}
+
+#ifdef BIGNUMBER_X86_64_SIMD
+			// The vector kernels use unaligned loads and stores since the buffers
+			// only have the alignment of the allocator, and finish the last few limbs
+			// one at a time. Each vector is loaded before anything is stored so the
+			// output can be an input. SSE2 is always there on x86-64; AVX2 and
+			// AVX-512 are picked when the cpu and operating system support them.
+
+			// bitwiseSse2 does the operation two limbs at a time
+			template <Bitwise Operation>
+			void bitwiseSse2(limb *r, const limb *a, const limb *b, size_t size)
+			{
+				const __m128i ones = _mm_set1_epi32(-1);
+				size_t i = 0;
+
+				for (; i + 2 <= size; i += 2)
+				{
+					const __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+					const __m128i y = Operation == Bitwise::Not ? ones : _mm_loadu_si128((const __m128i *)(b + i));
+					__m128i value;
+
+					switch (Operation)
+					{
+					case Bitwise::And:
+						value = _mm_and_si128(x, y);
+						break;
+					case Bitwise::Or:
+						value = _mm_or_si128(x, y);
+						break;
+					default:
+						value = _mm_xor_si128(x, y); // NOT is XOR with all ones
+						break;
+					}
+
+					_mm_storeu_si128((__m128i *)(r + i), value);
+				}
+
+				for (; i < size; ++i)
+					r[i] = bitwiseItem<Operation>(a[i], Operation == Bitwise::Not ? 0 : b[i]);
+			}
+
+			// bitwiseAvx2 does the operation four limbs at a time
+			template <Bitwise Operation>
+			BIGNUMBER_TARGET("avx2") void bitwiseAvx2(limb *r, const limb *a, const limb *b, size_t size)
+			{
+				const __m256i ones = _mm256_set1_epi32(-1);
+				size_t i = 0;
+
+				for (; i + 4 <= size; i += 4)
+				{
+					const __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+					const __m256i y = Operation == Bitwise::Not ? ones : _mm256_loadu_si256((const __m256i *)(b + i));
+					__m256i value;
+
+					switch (Operation)
+					{
+					case Bitwise::And:
+						value = _mm256_and_si256(x, y);
+						break;
+					case Bitwise::Or:
+						value = _mm256_or_si256(x, y);
+						break;
+					default:
+						value = _mm256_xor_si256(x, y); // NOT is XOR with all ones
+						break;
+					}
+
+					_mm256_storeu_si256((__m256i *)(r + i), value);
+				}
+
+				for (; i < size; ++i)
+					r[i] = bitwiseItem<Operation>(a[i], Operation == Bitwise::Not ? 0 : b[i]);
+			}
+
+			// GCC's AVX-512 headers set off -Wmaybe-uninitialized in code that uses them
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+			// bitwiseAvx512 does the operation eight limbs at a time
+			template <Bitwise Operation>
+			BIGNUMBER_TARGET("avx512f") void bitwiseAvx512(limb *r, const limb *a, const limb *b, size_t size)
+			{
+				const __m512i ones = _mm512_set1_epi32(-1);
+				size_t i = 0;
+
+				for (; i + 8 <= size; i += 8)
+				{
+					const __m512i x = _mm512_loadu_si512((const void *)(a + i));
+					const __m512i y = Operation == Bitwise::Not ? ones : _mm512_loadu_si512((const void *)(b + i));
+					__m512i value;
+
+					switch (Operation)
+					{
+					case Bitwise::And:
+						value = _mm512_and_si512(x, y);
+						break;
+					case Bitwise::Or:
+						value = _mm512_or_si512(x, y);
+						break;
+					default:
+						value = _mm512_xor_si512(x, y); // NOT is XOR with all ones
+						break;
+					}
+
+					_mm512_storeu_si512((void *)(r + i), value);
+				}
+
+				for (; i < size; ++i)
+					r[i] = bitwiseItem<Operation>(a[i], Operation == Bitwise::Not ? 0 : b[i]);
+			}
+
+			// lshiftAvx2 shifts four limbs at a time from the most significant limb
+			// down. every limb needs the one below it, so the loop stops one early
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("avx2") limb lshiftAvx2(limb *r, const limb *a, size_t size, unsigned int count)
+			{
+				const limb retVal = a[size - 1] >> (limbBits - count);
+				const __m128i left = _mm_cvtsi32_si128((int)count), right = _mm_cvtsi32_si128((int)(limbBits - count));
+				size_t i = size;
+
+				while (i >= 5)
+				{
+					i -= 4;
+					const __m256i high = _mm256_loadu_si256((const __m256i *)(a + i));
+					const __m256i low = _mm256_loadu_si256((const __m256i *)(a + i - 1));
+					_mm256_storeu_si256((__m256i *)(r + i), _mm256_or_si256(_mm256_sll_epi64(high, left), _mm256_srl_epi64(low, right)));
+				}
+
+				for (; i > 1; --i)
+					r[i - 1] = (a[i - 1] << count) | (a[i - 2] >> (limbBits - count));
+
+				r[0] = a[0] << count;
+				return retVal;
+			}
+
+			// rshiftAvx2 shifts four limbs at a time from the least significant limb
+			// up. every limb needs the one above it, so the loop stops one early
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("avx2") limb rshiftAvx2(limb *r, const limb *a, size_t size, unsigned int count)
+			{
+				const limb retVal = a[0] << (limbBits - count);
+				const __m128i right = _mm_cvtsi32_si128((int)count), left = _mm_cvtsi32_si128((int)(limbBits - count));
+				size_t i = 0;
+
+				for (; i + 5 <= size; i += 4)
+				{
+					const __m256i low = _mm256_loadu_si256((const __m256i *)(a + i));
+					const __m256i high = _mm256_loadu_si256((const __m256i *)(a + i + 1));
+					_mm256_storeu_si256((__m256i *)(r + i), _mm256_or_si256(_mm256_srl_epi64(low, right), _mm256_sll_epi64(high, left)));
+				}
+
+				for (; i + 1 < size; ++i)
+					r[i] = (a[i] >> count) | (a[i + 1] << (limbBits - count));
+
+				r[size - 1] = a[size - 1] >> count;
+				return retVal;
+			}
+
+			// lshiftAvx512 is lshiftAvx2 with eight limbs at a time
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("avx512f") limb lshiftAvx512(limb *r, const limb *a, size_t size, unsigned int count)
+			{
+				const limb retVal = a[size - 1] >> (limbBits - count);
+				const __m128i left = _mm_cvtsi32_si128((int)count), right = _mm_cvtsi32_si128((int)(limbBits - count));
+				size_t i = size;
+
+				while (i >= 9)
+				{
+					i -= 8;
+					const __m512i high = _mm512_loadu_si512((const void *)(a + i));
+					const __m512i low = _mm512_loadu_si512((const void *)(a + i - 1));
+					_mm512_storeu_si512((void *)(r + i), _mm512_or_si512(_mm512_sll_epi64(high, left), _mm512_srl_epi64(low, right)));
+				}
+
+				for (; i > 1; --i)
+					r[i - 1] = (a[i - 1] << count) | (a[i - 2] >> (limbBits - count));
+
+				r[0] = a[0] << count;
+				return retVal;
+			}
+
+			// rshiftAvx512 is rshiftAvx2 with eight limbs at a time
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("avx512f") limb rshiftAvx512(limb *r, const limb *a, size_t size, unsigned int count)
+			{
+				const limb retVal = a[0] << (limbBits - count);
+				const __m128i right = _mm_cvtsi32_si128((int)count), left = _mm_cvtsi32_si128((int)(limbBits - count));
+				size_t i = 0;
+
+				for (; i + 9 <= size; i += 8)
+				{
+					const __m512i low = _mm512_loadu_si512((const void *)(a + i));
+					const __m512i high = _mm512_loadu_si512((const void *)(a + i + 1));
+					_mm512_storeu_si512((void *)(r + i), _mm512_or_si512(_mm512_srl_epi64(low, right), _mm512_sll_epi64(high, left)));
+				}
+
+				for (; i + 1 < size; ++i)
+					r[i] = (a[i] >> count) | (a[i + 1] << (limbBits - count));
+
+				r[size - 1] = a[size - 1] >> count;
+				return retVal;
+			}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+			// popcountHardware counts the bits with the popcnt instruction, which
+			// isn't part of the baseline x86-64 the rest of the file is built for.
+			// the four counts keep the additions from waiting on each other
+			BIGNUMBER_INLINE BIGNUMBER_TARGET("popcnt") size_t popcountHardware(const limb *a, size_t size)
+			{
+				size_t count0 = 0, count1 = 0, count2 = 0, count3 = 0;
+				size_t i = 0;
+
+				for (; i + 4 <= size; i += 4)
+				{
+					count0 += (size_t)_mm_popcnt_u64(a[i]);
+					count1 += (size_t)_mm_popcnt_u64(a[i + 1]);
+					count2 += (size_t)_mm_popcnt_u64(a[i + 2]);
+					count3 += (size_t)_mm_popcnt_u64(a[i + 3]);
+				}
+
+				for (; i < size; ++i)
+					count0 += (size_t)_mm_popcnt_u64(a[i]);
+
+				return count0 + count1 + count2 + count3;
+			}
+
+			// checks if the cpu has popcnt
+			BIGNUMBER_INLINE bool hasPopcnt()
+			{
+#if defined(__GNUC__)
+				__builtin_cpu_init(); // needed since this runs before main
+				return __builtin_cpu_supports("popcnt") != 0;
+#elif defined(_MSC_VER)
+				int info[4];
+				__cpuid(info, 1);
+				return (info[2] & (1 << 23)) != 0;
+#else
+				return false;
+#endif
+			}
+
+			// the widest vectors the cpu and operating system support
+			enum class VectorLevel { SSE2, AVX2, AVX512 };
+
+			BIGNUMBER_INLINE VectorLevel vectorLevel()
+			{
+#if defined(__GNUC__)
+				__builtin_cpu_init(); // needed since this runs before main
+
+				if (__builtin_cpu_supports("avx512f"))
+					return VectorLevel::AVX512;
+
+				if (__builtin_cpu_supports("avx2"))
+					return VectorLevel::AVX2;
+#elif defined(_MSC_VER)
+				int info[4];
+				__cpuid(info, 0);
+				const int maxLeaf = info[0];
+
+				// the operating system has to save the vector registers (OSXSAVE and XCR0)
+				__cpuid(info, 1);
+
+				if (maxLeaf >= 7 && (info[2] & (1 << 27)) != 0)
+				{
+					const unsigned long long enabled = _xgetbv(0);
+					__cpuidex(info, 7, 0);
+
+					if ((enabled & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0)
+						return VectorLevel::AVX512;
+
+					if ((enabled & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0)
+						return VectorLevel::AVX2;
+				}
+#endif
+
+				return VectorLevel::SSE2;
+			}
+#endif
+
+			// the kernels picked for the cpu the program is running on
+			struct Dispatch
+			{
+				limb (*addN)(limb *, const limb *, const limb *, size_t);
+				limb (*subN)(limb *, const limb *, const limb *, size_t);
+				limb (*mul1)(limb *, const limb *, size_t, limb);
+				limb (*addmul1)(limb *, const limb *, size_t, limb);
+				limb (*submul1)(limb *, const limb *, size_t, limb);
+				limb (*lshift)(limb *, const limb *, size_t, unsigned int);
+				limb (*rshift)(limb *, const limb *, size_t, unsigned int);
+				void (*andN)(limb *, const limb *, const limb *, size_t);
+				void (*orN)(limb *, const limb *, const limb *, size_t);
+				void (*xorN)(limb *, const limb *, const limb *, size_t);
+				void (*notN)(limb *, const limb *, const limb *, size_t);
+				size_t (*popcount)(const limb *, size_t);
+				const char *name;
+			};
+
+			// this starts out with the portable kernels so anything that runs before
+			// selectKernels (like the constructors of other global objects) still works
+			BIGNUMBER_INLINE Dispatch dispatch = { addNPortable, subNPortable, mul1Portable, addmul1Portable,
+				submul1Portable, lshiftPortable, rshiftPortable, bitwisePortable<Bitwise::And>,
+				bitwisePortable<Bitwise::Or>, bitwisePortable<Bitwise::Xor>, bitwisePortable<Bitwise::Not>,
+				popcountPortable, "portable" };
+
+			// selectKernels puts the fastest kernels for the cpu in dispatch
+			BIGNUMBER_INLINE bool selectKernels()
+			{
+				const char *vectorName = ""; // added to the name if there are vector kernels
+
+#ifdef BIGNUMBER_X86_64_ASM
+				dispatch.addN = addNAsm;
+				dispatch.subN = subNAsm;
+				dispatch.lshift = lshiftAsm;
+				dispatch.rshift = rshiftAsm;
+				dispatch.name = "x86-64";
+
+				if (hasMulxAndAdx())
+				{
+					dispatch.mul1 = mul1Asm;
+					dispatch.addmul1 = addmul1Asm;
+					dispatch.submul1 = submul1Asm;
+					dispatch.name = "x86-64 BMI2/ADX";
+				}
+#endif
+
+#ifdef BIGNUMBER_X86_64_SIMD
+				switch (vectorLevel())
+				{
+				case VectorLevel::AVX512:
+					dispatch.andN = bitwiseAvx512<Bitwise::And>;
+					dispatch.orN = bitwiseAvx512<Bitwise::Or>;
+					dispatch.xorN = bitwiseAvx512<Bitwise::Xor>;
+					dispatch.notN = bitwiseAvx512<Bitwise::Not>;
+					dispatch.lshift = lshiftAvx512;
+					dispatch.rshift = rshiftAvx512;
+					vectorName = " AVX-512";
+					break;
+				case VectorLevel::AVX2:
+					dispatch.andN = bitwiseAvx2<Bitwise::And>;
+					dispatch.orN = bitwiseAvx2<Bitwise::Or>;
+					dispatch.xorN = bitwiseAvx2<Bitwise::Xor>;
+					dispatch.notN = bitwiseAvx2<Bitwise::Not>;
+					dispatch.lshift = lshiftAvx2;
+					dispatch.rshift = rshiftAvx2;
+					vectorName = " AVX2";
+					break;
+				default:
+					dispatch.andN = bitwiseSse2<Bitwise::And>;
+					dispatch.orN = bitwiseSse2<Bitwise::Or>;
+					dispatch.xorN = bitwiseSse2<Bitwise::Xor>;
+					dispatch.notN = bitwiseSse2<Bitwise::Not>;
+					vectorName = " SSE2";
+					break;
+				}
+
+				if (hasPopcnt())
+					dispatch.popcount = popcountHardware;
+#endif
+
+				static std::string description;
+				description = std::string(dispatch.name) + vectorName;
+				dispatch.name = description.c_str();
+
+				return true;
+			}
+
+			BIGNUMBER_INLINE const bool kernelsSelected = selectKernels(); // done when the program starts
+		} // namespace detail
+
+		// compare compares from the most significant limb down
+		BIGNUMBER_INLINE int compare(const limb *a, const limb *b, size_t size)
+		{
+			while (size-- > 0)
+			{
+				if (a[size] != b[size])
+					return a[size] < b[size] ? -1 : 1;
+			}
+
+			return 0;
+		}
+
+		// add1 adds a single limb to an array
+		BIGNUMBER_INLINE limb add1(limb *r, const limb *a, size_t size, limb b)
+		{
+			size_t i = 0;
+
+			// loop until there is nothing left to carry
+			for (; i < size && b != 0; ++i)
+			{
+				r[i] = a[i] + b;
+				b = r[i] < b ? 1 : 0;
+			}
+
+			// copy the rest if the output isn't the input
+			if (r != a)
+				std::copy(a + i, a + size, r + i);
+
+			return b;
+		}
+
+		// addN adds two arrays with the same size
+		BIGNUMBER_INLINE limb addN(limb *r, const limb *a, const limb *b, size_t size)
+		{
+			return size != 0 ? dispatch.addN(r, a, b, size) : 0;
+		}
+
+		// add adds two arrays where the first one is at least as long as the second
+		BIGNUMBER_INLINE limb add(limb *r, const limb *a, size_t aSize, const limb *b, size_t bSize)
+		{
+			const limb carry = addN(r, a, b, bSize);
+			return add1(r + bSize, a + bSize, aSize - bSize, carry);
+		}
+
+		// sub1 subtracts a single limb from an array
+		BIGNUMBER_INLINE limb sub1(limb *r, const limb *a, size_t size, limb b)
+		{
+			size_t i = 0;
+
+			// loop until there is nothing left to borrow
+			for (; i < size && b != 0; ++i)
+			{
+				const limb value = a[i];
+				r[i] = value - b;
+				b = value < b ? 1 : 0;
+			}
+
+			// copy the rest if the output isn't the input
+			if (r != a)
+				std::copy(a + i, a + size, r + i);
+
+			return b;
+		}
+
+		// subN subtracts two arrays with the same size
+		BIGNUMBER_INLINE limb subN(limb *r, const limb *a, const limb *b, size_t size)
+		{
+			return size != 0 ? dispatch.subN(r, a, b, size) : 0;
+		}
+
+		// sub subtracts two arrays where the first one is at least as long as the second
+		BIGNUMBER_INLINE limb sub(limb *r, const limb *a, size_t aSize, const limb *b, size_t bSize)
+		{
+			const limb borrow = subN(r, a, b, bSize);
+			return sub1(r + bSize, a + bSize, aSize - bSize, borrow);
+		}
+
+		// mul1 multiplies an array by a single limb
+		BIGNUMBER_INLINE limb mul1(limb *r, const limb *a, size_t size, limb b)
+		{
+			return size != 0 ? dispatch.mul1(r, a, size, b) : 0;
+		}
+
+		// addmul1 multiplies an array by a single limb and adds it to the output
+		BIGNUMBER_INLINE limb addmul1(limb *r, const limb *a, size_t size, limb b)
+		{
+			return size != 0 ? dispatch.addmul1(r, a, size, b) : 0;
+		}
+
+		// submul1 multiplies an array by a single limb and subtracts it from the output
+		BIGNUMBER_INLINE limb submul1(limb *r, const limb *a, size_t size, limb b)
+		{
+			return size != 0 ? dispatch.submul1(r, a, size, b) : 0;
+		}
+
+		// the thresholds being used. they're behind a function with external linkage so
+		// header only builds share one copy between the translation units
+		struct ThresholdState
+		{
+			std::atomic<size_t> multiply{BIGNUMBER_MULTIPLY_THRESHOLD};
+			std::atomic<size_t> square{BIGNUMBER_SQUARE_THRESHOLD};
+			std::atomic<size_t> conversion{BIGNUMBER_CONVERSION_THRESHOLD};
+		};
+
+		BIGNUMBER_INLINE ThresholdState &thresholdState()
+		{
+			static ThresholdState state;
+			return state;
+		}
+
+		namespace detail
+		{
+			// mulBasecase uses the schoolbook method, one row for every limb of b
+			BIGNUMBER_INLINE void mulBasecase(limb *r, const limb *a, size_t aSize, const limb *b, size_t bSize)
+			{
+				r[aSize] = mul1(r, a, aSize, b[0]);
+
+				for (size_t i = 1; i < bSize; ++i)
+					r[aSize + i] = addmul1(r + i, a, aSize, b[i]);
+			}
+
+			// subtractAbs sets r to |a - b| (with the size of a, which is at least the
+			// size of b) and returns true when b was bigger
+			BIGNUMBER_INLINE bool subtractAbs(limb *r, const limb *a, size_t aSize, const limb *b, size_t bSize)
+			{
+				if (normalizedSize(a + bSize, aSize - bSize) == 0 && compare(a, b, bSize) < 0)
+				{
+					subN(r, b, a, bSize);
+					std::fill(r + bSize, r + aSize, 0);
+					return true;
+				}
+
+				sub(r, a, aSize, b, bSize);
+				return false;
+			}
+
+			// karatsubaScratch returns the number of scratch limbs karatsuba needs for a size
+			BIGNUMBER_INLINE size_t karatsubaScratch(size_t size, size_t threshold)
+			{
+				size_t retVal = 0;
+
+				while (size >= threshold)
+				{
+					const size_t high = size - size / 2;
+					retVal += 6 * high + 1;
+					size = high;
+				}
+
+				return retVal;
+			}
+
+			BIGNUMBER_INLINE void karatsuba(limb *, const limb *, const limb *, size_t, size_t, limb *);
+
+			// mulRecursive multiplies two arrays with the same size. the threshold is read
+			// once for the whole product since the scratch was worked out with it
+			BIGNUMBER_INLINE void mulRecursive(limb *r, const limb *a, const limb *b, size_t size, size_t threshold, limb *scratch)
+			{
+				if (size < threshold)
+					mulBasecase(r, a, size, b, size);
+				else
+					karatsuba(r, a, b, size, threshold, scratch);
+			}
+
+			// karatsuba splits both arrays in half (a = a1 * B + a0) and uses three half
+			// size products instead of four since a0 * b1 + a1 * b0 is the same as
+			// a0 * b0 + a1 * b1 + (a0 - a1) * (b1 - b0). squares skip half the work for
+			// the differences. when the operands are big enough the three products are
+			// worked out on the thread pool, each with its own scratch
+			BIGNUMBER_INLINE void karatsuba(limb *r, const limb *a, const limb *b, size_t size, size_t threshold, limb *scratch)
+			{
+				const size_t low = size / 2, high = size - low;
+				const bool square = a == b;
+
+				limb *aDiff = scratch; // |a0 - a1|
+				limb *bDiff = square ? aDiff : scratch + high; // |b1 - b0|
+				limb *middle = scratch + 2 * high; // (a0 - a1) * (b1 - b0)
+				limb *sum = middle + 2 * high; // the middle terms added together
+				limb *next = sum + 2 * high + 1; // scratch for the smaller products
+
+				// the product of the differences is negative when a0 > a1 and b0 > b1 or
+				// when neither is. (a0 - a1) * (a1 - a0) is never positive
+				const bool aLowBigger = subtractAbs(aDiff, a + low, high, a, low);
+				const bool negative = square || subtractAbs(bDiff, b + low, high, b, low) == aLowBigger;
+
+				if (size >= BigThreadPool::parallelThreshold() && BigThreadPool::threadCount() > 1)
+				{
+					const size_t nextSize = karatsubaScratch(high, threshold);
+					std::vector<limb> lowScratch(nextSize), highScratch(nextSize);
+
+					const std::function<void()> tasks[] =
+					{
+						[&]() { mulRecursive(middle, aDiff, bDiff, high, threshold, next); },
+						[&]() { mulRecursive(r, a, b, low, threshold, lowScratch.data()); },
+						[&]() { mulRecursive(r + 2 * low, a + low, b + low, high, threshold, highScratch.data()); }
+					};
+
+					BigThreadPool::run(tasks, 3);
+				}
+				else
+				{
+					mulRecursive(r, a, b, low, threshold, next);
+					mulRecursive(r + 2 * low, a + low, b + low, high, threshold, next);
+					mulRecursive(middle, aDiff, bDiff, high, threshold, next);
+				}
+
+				// sum = a0 * b0 + a1 * b1 -/+ |a0 - a1| * |b1 - b0|
+				sum[2 * high] = add(sum, r + 2 * low, 2 * high, r, 2 * low);
+
+				if (negative)
+					sub(sum, sum, 2 * high + 1, middle, 2 * high);
+				else
+					add(sum, sum, 2 * high + 1, middle, 2 * high);
+
+				// add the middle terms to the product (the carry can't go past the end)
+				add(r + low, r + low, size + high, sum, 2 * high + 1);
+			}
+		} // namespace detail
+
+		// mul uses the schoolbook method for small arrays and Karatsuba for big ones.
+		// when a is longer than b it's multiplied in pieces the size of b. every
+		// product in a square is a square too, so it has its own threshold
+		BIGNUMBER_INLINE void mul(limb *r, const limb *a, size_t aSize, const limb *b, size_t bSize)
+		{
+			const ThresholdState &state = thresholdState();
+			const bool square = a == b && aSize == bSize;
+			const size_t threshold = (square ? state.square : state.multiply).load(std::memory_order_relaxed);
+
+			if (bSize < threshold)
+			{
+				BIGNUMBER_TIME_ALGORITHM(square ? BigInstrumentation::Algorithm::SchoolbookSquare : BigInstrumentation::Algorithm::SchoolbookMultiply);
+				mulBasecase(r, a, aSize, b, bSize);
+				return;
+			}
+
+			BIGNUMBER_TIME_ALGORITHM(square ? BigInstrumentation::Algorithm::KaratsubaSquare : BigInstrumentation::Algorithm::KaratsubaMultiply);
+
+			std::vector<limb> scratch(karatsubaScratch(bSize, threshold));
+
+			if (aSize == bSize)
+			{
+				karatsuba(r, a, b, bSize, threshold, scratch.data());
+				return;
+			}
+
+			// the first piece goes straight into the output
+			mulRecursive(r, a, b, bSize, threshold, scratch.data());
+
+			std::vector<limb> product(2 * bSize);
+			size_t done = bSize;
+
+			for (; done + bSize <= aSize; done += bSize)
+			{
+				mulRecursive(product.data(), a + done, b, bSize, threshold, scratch.data());
+				add(r + done, product.data(), 2 * bSize, r + done, bSize); // there's never a carry
+			}
+
+			// the last piece is shorter than b
+			if (done < aSize)
+			{
+				const size_t rest = aSize - done;
+				mul(product.data(), b, bSize, a + done, rest);
+				add(r + done, product.data(), bSize + rest, r + done, bSize);
+			}
+		}
+
+		// divRem1 divides an array by a single limb from the most significant limb down
+		BIGNUMBER_INLINE limb divRem1(limb *q, const limb *a, size_t size, limb d)
+		{
+			limb remainder = 0;
+
+			while (size-- > 0)
+				q[size] = divWide(remainder, a[size], d, remainder);
+
+			return remainder;
+		}
+
+		// divRem uses algorithm D from Knuth's The Art of Computer Programming (4.3.1)
+		BIGNUMBER_INLINE void divRem(limb *q, limb *r, const limb *a, size_t aSize, const limb *b, size_t bSize, limb *scratch)
+		{
+			limb *u = scratch; // normalized a with an extra limb on top
+			limb *v = scratch + aSize + 1; // normalized b
+
+			// shift both so the top bit of the divisor is set, this
+			// makes the estimated quotient limb off by two at most
+			const unsigned int shift = leadingZeroBits(b[bSize - 1]);
+
+			if (shift != 0)
+			{
+				lshift(v, b, bSize, shift);
+				u[aSize] = lshift(u, a, aSize, shift);
+			}
+			else
+			{
+				std::copy(b, b + bSize, v);
+				std::copy(a, a + aSize, u);
+				u[aSize] = 0;
+			}
+
+			const limb vTop = v[bSize - 1], vNext = v[bSize - 2];
+
+			// get one limb of the quotient at a time
+			for (size_t j = aSize - bSize + 1; j-- > 0;)
+			{
+				limb estimate, rest, high, low;
+				bool restOverflow = false;
+
+				// estimate the quotient limb using the top two limbs
+				if (u[j + bSize] >= vTop)
+				{
+					estimate = ~(limb)0;
+					rest = u[j + bSize - 1] + vTop;
+					restOverflow = rest < vTop;
+				}
+				else
+					estimate = divWide(u[j + bSize], u[j + bSize - 1], vTop, rest);
+
+				// use the next limb to fix the estimate
+				while (!restOverflow)
+				{
+					low = mulWide(estimate, vNext, high);
+
+					if (high < rest || (high == rest && low <= u[j + bSize - 2]))
+						break;
+
+					--estimate;
+					rest += vTop;
+					restOverflow = rest < vTop;
+				}
+
+				// subtract the estimate times the divisor
+				const limb borrow = submul1(u + j, v, bSize, estimate);
+				const limb top = u[j + bSize];
+				u[j + bSize] = top - borrow;
+
+				// the estimate was one too big so add the divisor back
+				if (top < borrow)
+				{
+					--estimate;
+					u[j + bSize] += addN(u + j, u + j, v, bSize);
+				}
+
+				q[j] = estimate;
+			}
+
+			// undo the normalization to get the remainder
+			if (shift != 0)
+				rshift(r, u, bSize, shift);
+			else
+				std::copy(u, u + bSize, r);
+		}
+
+		// lshift shifts from the most significant limb down
+		BIGNUMBER_INLINE limb lshift(limb *r, const limb *a, size_t size, unsigned int count)
+		{
+			return dispatch.lshift(r, a, size, count);
+		}
+
+		// rshift shifts from the least significant limb up
+		BIGNUMBER_INLINE limb rshift(limb *r, const limb *a, size_t size, unsigned int count)
+		{
+			return dispatch.rshift(r, a, size, count);
+		}
+
+		// andN does a bitwise AND on every limb
+		BIGNUMBER_INLINE void andN(limb *r, const limb *a, const limb *b, size_t size)
+		{
+			dispatch.andN(r, a, b, size);
+		}
+
+		// orN does a bitwise OR on every limb
+		BIGNUMBER_INLINE void orN(limb *r, const limb *a, const limb *b, size_t size)
+		{
+			dispatch.orN(r, a, b, size);
+		}
+
+		// xorN does a bitwise XOR on every limb
+		BIGNUMBER_INLINE void xorN(limb *r, const limb *a, const limb *b, size_t size)
+		{
+			dispatch.xorN(r, a, b, size);
+		}
+
+		// notN does a bitwise NOT on every limb
+		BIGNUMBER_INLINE void notN(limb *r, const limb *a, size_t size)
+		{
+			dispatch.notN(r, a, nullptr, size);
+		}
+
+		// leadingZeros counts the zero bits above the highest set bit
+		BIGNUMBER_INLINE unsigned int leadingZeros(limb value)
+		{
+			return leadingZeroBits(value);
+		}
+
+		// trailingZeros counts the zero bits below the lowest set bit
+		BIGNUMBER_INLINE unsigned int trailingZeros(limb value)
+		{
+			return trailingZeroBits(value);
+		}
+
+		// popcount counts the set bits in every limb
+		BIGNUMBER_INLINE size_t popcount(const limb *a, size_t size)
+		{
+			return dispatch.popcount(a, size);
+		}
+
+		// thresholds reads all of them (each one on its own, so a change made at the
+		// same time can show up in some and not the others)
+		BIGNUMBER_INLINE Thresholds thresholds()
+		{
+			const ThresholdState &state = thresholdState();
+			Thresholds retVal;
+			retVal.multiply = state.multiply.load(std::memory_order_relaxed);
+			retVal.square = state.square.load(std::memory_order_relaxed);
+			retVal.conversion = state.conversion.load(std::memory_order_relaxed);
+			return retVal;
+		}
+
+		// setThresholds checks them all before changing any
+		BIGNUMBER_INLINE void setThresholds(const Thresholds &values)
+		{
+			if (values.multiply < 2 || values.square < 2)
+				throw std::out_of_range("Kernels::setThresholds: Karatsuba needs a threshold of at least 2 limbs");
+
+			if (values.conversion < 1)
+				throw std::out_of_range("Kernels::setThresholds: the conversion threshold has to be at least 1 limb");
+
+			ThresholdState &state = thresholdState();
+			state.multiply.store(values.multiply, std::memory_order_relaxed);
+			state.square.store(values.square, std::memory_order_relaxed);
+			state.conversion.store(values.conversion, std::memory_order_relaxed);
+		}
+
+		// implementation gives the name of the kernels being used
+		BIGNUMBER_INLINE const char *implementation()
+		{
+			return dispatch.name;
+		}
+
+		// vectorBits asks the cpu each time so it works before the kernels are picked
+		BIGNUMBER_INLINE unsigned int vectorBits()
+		{
+#ifdef BIGNUMBER_X86_64_SIMD
+			switch (vectorLevel())
+			{
+			case VectorLevel::AVX512:
+				return 512;
+			case VectorLevel::AVX2:
+				return 256;
+			default:
+				return 128;
+			}
+#else
+			return 0;
+#endif
+		}
+
+		// normalizedSize skips the leading zeros
+		BIGNUMBER_INLINE size_t normalizedSize(const limb *a, size_t size)
+		{
+			while (size > 0 && a[size - 1] == 0)
+				--size;
+
+			return size;
+		}
+	} // namespace Kernels
+} // namespace BigNumber
@@ -0,0 +1,150 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGKERNELS_H
+#define BIGKERNELS_H
+
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGKERNELS_H_SOURCES
+#endif
+
+#include "BigConfig.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace BigNumber
+{
+	// The kernels work on arrays of limbs (the data type of BigUnsigned) stored
+	// least significant limb first. They don't allocate anything; the caller
+	// makes sure every output array is big enough before calling them. Unless
+	// it says otherwise, an output array can be the same array as an input but
+	// can't partly overlap one.
+	namespace Kernels
+	{
+		// Limbs are 64 bits wherever the compiler can multiply two of them into a
+		// double width results without a library call (64-bit GCC, Clang and MSVC)
+		// and 32 bits everywhere else. Defining BIGNUMBER_LIMB_BITS as 32 or 64
+		// picks the size instead; it has to be the same for the library and
+		// everything that uses it.
+#ifndef BIGNUMBER_LIMB_BITS
+#if defined(__SIZEOF_INT128__) || defined(_M_X64) || defined(_M_ARM64)
+#define BIGNUMBER_LIMB_BITS 64
+#else
+#define BIGNUMBER_LIMB_BITS 32
+#endif
+#endif
+
+#if BIGNUMBER_LIMB_BITS == 64
+		typedef std::uint64_t limb; // 64-bit data type
+#elif BIGNUMBER_LIMB_BITS == 32
+		typedef std::uint32_t limb; // 32-bit data type
+#else
+#error "BIGNUMBER_LIMB_BITS has to be 32 or 64"
+#endif
+
+		static const size_t limbBits = 8 * sizeof(limb); // number of bits in a limb
+
+		/// Double width multiplication and division of single limbs
+		limb mulWide(limb, limb, limb &); // returns the low limb and sets the high limb
+		limb divWide(limb, limb, limb, limb &); // (high, low) / d where high < d, returns the quotient and sets the remainder
+
+		/// Comparison of two arrays with the same size (returns -1, 0 or 1)
+		int compare(const limb *, const limb *, size_t);
+
+		/// Addition (returns the carry)
+		limb add1(limb *, const limb *, size_t, limb);
+		limb addN(limb *, const limb *, const limb *, size_t);
+		limb add(limb *, const limb *, size_t, const limb *, size_t); // first size >= second size
+
+		/// Subtraction (returns the borrow)
+		limb sub1(limb *, const limb *, size_t, limb);
+		limb subN(limb *, const limb *, const limb *, size_t);
+		limb sub(limb *, const limb *, size_t, const limb *, size_t); // first size >= second size
+
+		/// Multiplication by a single limb (returns the high limb)
+		limb mul1(limb *, const limb *, size_t, limb);
+		limb addmul1(limb *, const limb *, size_t, limb); // adds the product to the output
+		limb submul1(limb *, const limb *, size_t, limb); // subtracts the product from the output
+
+		/// Multiplication (the output has room for both sizes added and can't be an input). big
+		/// products use Karatsuba, which allocates its own scratch and splits the work between
+		/// the threads of BigThreadPool when the second size is over the parallel threshold
+		void mul(limb *, const limb *, size_t, const limb *, size_t); // first size >= second size
+
+		/// Division by a single limb (returns the remainder, the quotient can be the input)
+		limb divRem1(limb *, const limb *, size_t, limb);
+
+		/// Division (the quotient has room for the first size minus the second size plus one limbs,
+		/// the remainder for the second size and the scratch for both sizes plus one. nothing can be an input)
+		void divRem(limb *, limb *, const limb *, size_t, const limb *, size_t, limb *); // second size >= 2, top limb not zero
+
+		/// Shifts by less than the number of bits in a limb (returns the bits shifted out)
+		limb lshift(limb *, const limb *, size_t, unsigned int); // the output can start at or above the input
+		limb rshift(limb *, const limb *, size_t, unsigned int); // the output can start at or below the input
+
+		/// Bitwise operations over arrays with the same size
+		void andN(limb *, const limb *, const limb *, size_t);
+		void orN(limb *, const limb *, const limb *, size_t);
+		void xorN(limb *, const limb *, const limb *, size_t);
+		void notN(limb *, const limb *, size_t);
+
+		/// Bit counting (the single limb versions can't be given zero)
+		unsigned int leadingZeros(limb); // zero bits above the highest set bit
+		unsigned int trailingZeros(limb); // zero bits below the lowest set bit
+		size_t popcount(const limb *, size_t); // set bits in the whole array
+
+		/// Number of limbs left after removing the leading zeros
+		size_t normalizedSize(const limb *, size_t);
+
+		/// Sizes (in limbs) where the algorithms change. the defaults are in BigTuning.h,
+		/// and bigint_tune measures them on the machine it runs on
+		struct Thresholds
+		{
+			size_t multiply; // smallest product that uses Karatsuba (at least 2)
+			size_t square; // smallest square that uses Karatsuba (at least 2)
+			size_t conversion; // smallest number split in half when converted to or from a string (at least 1)
+		};
+
+		/// Thresholds the library uses (they can be changed while other threads are using it)
+		Thresholds thresholds();
+		void setThresholds(const Thresholds &);
+
+		/// Name of the kernels picked for the cpu (the add, subtract, multiply by
+		/// a limb, shift, bitwise and popcount kernels are picked when the program starts)
+		const char *implementation();
+
+		/// Number of bits in the widest vectors the cpu and operating system support
+		/// (0 when the library wasn't built with vector kernels)
+		unsigned int vectorBits();
+	} // namespace Kernels
+} // namespace BigNumber
+
+#ifdef BIGKERNELS_H_SOURCES
+#include "BigSources.h"
+#endif
+
+#endif // BIGKERNELS_H
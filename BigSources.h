@@ -0,0 +1,52 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGSOURCES_H
+#define BIGSOURCES_H
+
+// Included by the first header a translation unit includes, once that header is
+// complete, when BIGNUMBER_HEADER_ONLY is defined (see BigConfig.h). Every header
+// comes first so the sources see all the declarations.
+#include "BigBatch.h"
+#include "BigExpression.h"
+#include "BigFixed.h"
+#include "BigInteger.h"
+#include "BigIntegerUtil.h"
+#include "BigInstrumentation.h"
+#include "BigKernels.h"
+#include "BigThreadPool.h"
+#include "BigUnsigned.h"
+#include "BigUnsignedPool.h"
+
+#include "BigBatch.cpp"
+#include "BigInteger.cpp"
+#include "BigIntegerUtil.cpp"
+#include "BigInstrumentation.cpp"
+#include "BigKernels.cpp"
+#include "BigThreadPool.cpp"
+#include "BigUnsigned.cpp"
+#include "BigUnsignedPool.cpp"
+
+#endif // BIGSOURCES_H
@@ -0,0 +1,363 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#include "BigThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BigNumber
+{
+	// the threads and their queues
+	struct BigThreadPool::Shared
+	{
+		// the tasks given to one call of run. whoever gets to the group first
+		// takes the next task that hasn't been started
+		struct Group
+		{
+			const std::function<void()> *tasks; // the tasks
+			size_t count; // number of tasks
+			std::atomic<size_t> next{0}; // next task to start
+			std::atomic<size_t> pending; // tasks that haven't finished
+			std::mutex lock; // guards the error and the signal
+			std::condition_variable done; // signaled when every task is finished
+			std::exception_ptr error; // first exception thrown by a task
+
+			Group(const std::function<void()> *tasks, size_t count) :tasks(tasks), count(count), pending(count) {}
+
+			// runs the next task and returns false when they have all been started
+			bool runNext()
+			{
+				const size_t index = next++;
+
+				if (index >= count)
+					return false;
+
+				try
+				{
+					tasks[index]();
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> guard(lock);
+
+					if (!error)
+						error = std::current_exception();
+				}
+
+				if (--pending == 0)
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					done.notify_all();
+				}
+
+				return true;
+			}
+		};
+
+		typedef std::shared_ptr<Group> Job; // one entry in a queue runs one task of the group
+
+		// a queue of jobs with its own lock
+		struct Queue
+		{
+			std::mutex lock;
+			std::deque<Job> jobs;
+		};
+
+		// returns the default number of threads
+		static size_t defaultThreadCount()
+		{
+#ifdef BIGNUMBER_SINGLE_THREADED
+			return 1;
+#else
+			const size_t count = std::thread::hardware_concurrency();
+			return count != 0 ? count : 1;
+#endif
+		}
+
+		std::vector<std::unique_ptr<Queue>> queues; // queue of every thread (the last one is for threads outside the pool)
+		std::vector<std::thread> threads; // the helper threads (one less than the thread count)
+		std::shared_ptr<BigExecutor> executor; // runs the tasks instead of the threads when set
+		std::atomic<size_t> queued{0}; // number of jobs in all the queues
+		std::atomic<size_t> sleeping{0}; // number of threads waiting for jobs
+		std::atomic<bool> stopping{false}; // the helper threads should exit
+		std::mutex lock; // guards starting the threads and sleeping
+		std::condition_variable wake; // signaled when a job is queued or the threads should stop
+		std::atomic<size_t> count{defaultThreadCount()}; // number of threads to use
+		std::atomic<size_t> threshold{2048}; // smallest operand split between threads (limbs)
+
+		~Shared()
+		{
+			stop();
+		}
+
+		// returns the index of the calling thread's queue
+		static size_t &currentQueue()
+		{
+			static thread_local size_t index = (size_t)-1; // threads outside the pool don't have one
+			return index;
+		}
+
+		// adds jobs to the back of the calling thread's queue
+		void push(const Job &job, size_t copies)
+		{
+			size_t index = currentQueue();
+
+			if (index >= queues.size())
+				index = queues.size() - 1;
+
+			{
+				std::lock_guard<std::mutex> guard(queues[index]->lock);
+				queues[index]->jobs.insert(queues[index]->jobs.end(), copies, job);
+			}
+
+			queued += copies;
+
+			// take the lock so a thread that's about to sleep doesn't miss the signal
+			if (sleeping != 0)
+			{
+				{
+					std::lock_guard<std::mutex> guard(lock);
+				}
+
+				wake.notify_all();
+			}
+		}
+
+		// takes a job from the back of the calling thread's queue or steals one from
+		// the front of another queue. returns false when every queue is empty
+		bool take(Job &job)
+		{
+			if (queued == 0)
+				return false;
+
+			const size_t size = queues.size(), own = currentQueue();
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				const size_t index = own < size ? (own + i) % size : i;
+				Queue &queue = *queues[index];
+				std::lock_guard<std::mutex> guard(queue.lock);
+
+				if (!queue.jobs.empty())
+				{
+					if (i == 0 && own < size)
+					{
+						job = std::move(queue.jobs.back());
+						queue.jobs.pop_back();
+					}
+					else
+					{
+						job = std::move(queue.jobs.front());
+						queue.jobs.pop_front();
+					}
+
+					--queued;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// loop of every helper thread
+		void work(size_t index)
+		{
+			currentQueue() = index;
+			Job job;
+
+			while (!stopping)
+			{
+				if (take(job))
+				{
+					job->runNext();
+					job.reset();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> guard(lock);
+				++sleeping;
+				wake.wait(guard, [this]() { return stopping || queued != 0; });
+				--sleeping;
+			}
+		}
+
+		// starts the helper threads if they aren't running
+		void start()
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			if (!queues.empty())
+				return;
+
+			for (size_t i = 0; i < count; ++i)
+				queues.emplace_back(new Queue());
+
+			for (size_t i = 1; i < count; ++i)
+				threads.emplace_back(&Shared::work, this, i - 1);
+		}
+
+		// stops the helper threads and waits for them to exit
+		void stop()
+		{
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				stopping = true;
+			}
+
+			wake.notify_all();
+
+			for (auto &worker : threads)
+				worker.join();
+
+			threads.clear();
+			queues.clear();
+			queued = 0;
+			stopping = false;
+		}
+	};
+
+	// shared returns the pool used by every thread
+	BIGNUMBER_INLINE BigThreadPool::Shared &BigThreadPool::shared()
+	{
+		static Shared pool;
+		return pool;
+	}
+
+	/// Set the number of threads
+	BIGNUMBER_INLINE void BigThreadPool::setThreadCount(size_t count)
+	{
+		Shared &pool = shared();
+
+		// the threads are started again the next time they're needed
+		pool.stop();
+#ifdef BIGNUMBER_SINGLE_THREADED
+		// the counts of shared data aren't atomic, so the work can't be
+		// split between threads that would copy the same values
+		static_cast<void>(count);
+		pool.count = 1;
+#else
+		pool.count = count != 0 ? count : 1;
+#endif
+	}
+
+	/// Get the number of threads
+	BIGNUMBER_INLINE size_t BigThreadPool::threadCount()
+	{
+		Shared &pool = shared();
+
+#ifndef BIGNUMBER_SINGLE_THREADED
+		if (pool.executor)
+			return pool.executor->concurrency();
+#endif
+
+		return pool.count;
+	}
+
+	/// Set the executor
+	BIGNUMBER_INLINE void BigThreadPool::setExecutor(std::shared_ptr<BigExecutor> executor)
+	{
+		Shared &pool = shared();
+
+		// the pool's threads aren't needed while there's an executor
+		pool.stop();
+		pool.executor = std::move(executor);
+	}
+
+	/// Set the parallel threshold
+	BIGNUMBER_INLINE void BigThreadPool::setParallelThreshold(size_t limbs)
+	{
+		shared().threshold = limbs;
+	}
+
+	/// Get the parallel threshold
+	BIGNUMBER_INLINE size_t BigThreadPool::parallelThreshold()
+	{
+		return shared().threshold;
+	}
+
+	/// Run tasks on the pool
+	BIGNUMBER_INLINE void BigThreadPool::run(const std::function<void()> *tasks, size_t count)
+	{
+		Shared &pool = shared();
+
+		if (count == 0)
+			return;
+
+		if (threadCount() <= 1 || count == 1)
+		{
+			// no other threads so just run them
+			for (size_t i = 0; i < count; ++i)
+				tasks[i]();
+
+			return;
+		}
+
+		const Shared::Job group = std::make_shared<Shared::Group>(tasks, count);
+
+		if (pool.executor)
+		{
+			// every function runs tasks until they have all been started
+			const size_t helpers = std::min(count - 1, pool.executor->concurrency());
+
+			for (size_t i = 0; i < helpers; ++i)
+				pool.executor->execute([group]() { while (group->runNext()); });
+		}
+		else
+		{
+			pool.start();
+			pool.push(group, count - 1);
+		}
+
+		// run every task nobody else has started
+		while (group->runNext());
+
+		// help with other jobs until the tasks other threads started are done. when
+		// there's nothing to do the thread sleeps, which can't hold anything up
+		// since the threads running the tasks never wait on this one
+		Shared::Job job;
+
+		while (group->pending != 0)
+		{
+			if (!pool.executor && pool.take(job))
+			{
+				job->runNext();
+				job.reset();
+			}
+			else
+			{
+				std::unique_lock<std::mutex> guard(group->lock);
+				group->done.wait(guard, [&group]() { return group->pending == 0; });
+			}
+		}
+
+		if (group->error)
+			std::rethrow_exception(group->error);
+	}
+} // namespace BigNumber
@@ -0,0 +1,102 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGTHREADPOOL_H
+#define BIGTHREADPOOL_H
+
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGTHREADPOOL_H_SOURCES
+#endif
+
+#include "BigConfig.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace BigNumber
+{
+	/// Interface for running the library's parallel work on the application's own threads
+	class BigExecutor
+	{
+	public:
+		virtual ~BigExecutor() = default;
+
+		/// Run a function on one of the executor's threads (it doesn't have to start right away)
+		virtual void execute(std::function<void()>) = 0;
+
+		/// Number of threads the executor runs functions on
+		virtual size_t concurrency() const = 0;
+	};
+
+	// BigThreadPool is the scheduler every parallel algorithm of the library
+	// (multiplication, string conversion and batches) splits its work with, so
+	// none of them start threads of their own. Operations smaller than the
+	// parallel threshold never use it. The threads are started the first time
+	// they're needed.
+	//
+	// Every thread has its own queue. A thread adds the tasks it makes to the
+	// back of its queue and takes them back from there, and threads with nothing
+	// to do steal from the front of the other queues, which is where the biggest
+	// tasks are. The thread that calls run always runs any of its tasks nobody
+	// else has started, so tasks can call run again (nested parallelism) without
+	// waiting on threads that are all busy waiting themselves. That goes for an
+	// executor set with setExecutor too.
+	class BigThreadPool
+	{
+	public:
+		/// Number of threads used, counting the one that starts the work (one turns it off).
+		/// the default is the number of cores. when built with BIGNUMBER_SINGLE_THREADED it's
+		/// always one (an executor doesn't change that). it can only be changed while nothing
+		/// is running on the pool
+		static void setThreadCount(size_t);
+		static size_t threadCount();
+
+		/// Run the tasks on the application's executor instead of the pool's own threads
+		/// (nullptr goes back to the pool's threads). it can only be changed while nothing is running
+		static void setExecutor(std::shared_ptr<BigExecutor>);
+
+		/// Smallest number of limbs in an operand before an operation is split between threads
+		static void setParallelThreshold(size_t);
+		static size_t parallelThreshold();
+
+		/// Run the tasks and return when every one of them is done. the calling thread runs
+		/// some of them and the first exception thrown by a task is thrown again here
+		static void run(const std::function<void()> *, size_t);
+
+	private:
+		struct Shared; // the threads and their queues
+
+		/// Helper functions
+		static Shared &shared();
+	};
+} // namespace BigNumber
+
+#ifdef BIGTHREADPOOL_H_SOURCES
+#include "BigSources.h"
+#endif
+
+#endif // BIGTHREADPOOL_H
@@ -0,0 +1,49 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGTUNING_H
+#define BIGTUNING_H
+
+// The thresholds the library starts with (see Kernels::Thresholds), in limbs.
+// bigint_tune measures them on the machine it runs on and writes a header that
+// defines them; building with BIGNUMBER_TUNING_HEADER set to its path (in quotes)
+// uses those instead. Only the sources include this
+#ifdef BIGNUMBER_TUNING_HEADER
+#include BIGNUMBER_TUNING_HEADER
+#endif
+
+#ifndef BIGNUMBER_MULTIPLY_THRESHOLD
+#define BIGNUMBER_MULTIPLY_THRESHOLD 32 // smallest product that uses Karatsuba
+#endif
+
+#ifndef BIGNUMBER_SQUARE_THRESHOLD
+#define BIGNUMBER_SQUARE_THRESHOLD 32 // smallest square that uses Karatsuba
+#endif
+
+#ifndef BIGNUMBER_CONVERSION_THRESHOLD
+#define BIGNUMBER_CONVERSION_THRESHOLD 32 // smallest number split in half when converted to or from a string
+#endif
+
+#endif // BIGTUNING_H
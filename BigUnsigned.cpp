@@ -24,13 +24,30 @@ Email address: weston925@gmail.com
 */
 
 #include "BigUnsigned.h"
-
-using namespace std;
+#include "BigInstrumentation.h"
+#include "BigUnsignedPool.h"
+#include <algorithm>
 
 namespace BigNumber
 {
+	// C++17 defines these in the class, which header only builds need
+#ifndef BIGNUMBER_HEADER_ONLY
+	// definition of the number of bits in the data type
+	constexpr size_t BigUnsigned::dataTypeSize;
+
+	// definition of the value returned when there isn't a bit
+	constexpr size_t BigUnsigned::npos;
+#endif
+
+	/// Destructor
+	BIGNUMBER_INLINE BigUnsigned::~BigUnsigned()
+	{
+		// give the data back to the pool
+		releaseData();
+	}
+
 	/// Conversion operator to bool
-	BigUnsigned::operator bool() const
+	BIGNUMBER_INLINE BigUnsigned::operator bool() const
 	{
 		// this returns false only when the data is zero
 
@@ -40,15 +57,52 @@ namespace BigNumber
 			return false;
 	}
 
+	/// Copy assignment operator
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator =(const BigUnsigned &rhs)
+	{
+#ifdef BIGNUMBER_VALUE_SEMANTICS
+		if (this != &rhs)
+		{
+			if (rhs) // check if not zero
+			{
+				// copy the data into this data's buffer if it's big
+				// enough, otherwise get one from the pool
+				if (!pData || pData->capacity() < rhs.pData->size())
+				{
+					releaseData();
+					pData = BigUnsignedPool::acquire(rhs.pData->size());
+				}
+
+				pData->assign(std::begin(*rhs.pData), std::end(*rhs.pData));
+			}
+			else if (pData)
+				pData->clear(); // rhs is zero so this is zero
+		}
+#else
+		if (pData != rhs.pData) // check if they don't already share the data
+		{
+			releaseData(); // give the old data back to the pool
+			pData = rhs.pData; // share the data with rhs
+		}
+#endif
+
+		return *this;
+	}
+
 	/// Move assignment operator
-	BigUnsigned &BigUnsigned::operator =(BigUnsigned &&rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator =(BigUnsigned &&rhs)
 	{
-		pData = move(rhs.pData);
+		if (this != &rhs)
+		{
+			releaseData(); // give the old data back to the pool
+			pData = std::move(rhs.pData);
+		}
+
 		return *this;
 	}
 
 	/// Bool assignment operator
-	BigUnsigned &BigUnsigned::operator =(const bool &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator =(const bool &rhs)
 	{
 		// set the data to zero
 		clearData();
@@ -60,35 +114,21 @@ namespace BigNumber
 	}
 
 	/// Addition compound assignment operator
-	BigUnsigned &BigUnsigned::operator +=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator +=(const BigUnsigned &rhs)
 	{
 		if (rhs) // check if not zero
 		{
-			// things would mess up pretty badly if
-			// they are the exact same data (a += a)
-			// so makes sure it's not the same before
-			// adding
-			if (this != &rhs)
-			{
-				if (*this) // check if not zero
-					add(rhs); // add rhs into this
-				else
-					operator =(rhs); // the data is zero so just copy rhs
-			}
+			if (*this) // check if not zero
+				add(rhs); // add rhs into this (this works even when rhs is this)
 			else
-			{
-				// this and rhs is the exact same data so
-				// this creates a temporary BigUnsigned
-				// using rhs and then add them together
-				add(BigUnsigned(rhs));
-			}
+				operator =(rhs); // the data is zero so just copy rhs
 		}
 
 		return *this;
 	}
 
 	/// Subtraction compound assignment operator
-	BigUnsigned &BigUnsigned::operator -=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator -=(const BigUnsigned &rhs)
 	{
 		if (rhs) // check if not zero
 		{
@@ -97,43 +137,28 @@ namespace BigNumber
 			else if (*this == rhs)
 				clearData(); // subtracting two of the same value returns zero
 			else
-				throw runtime_error("BigUnsigned: Negative result in unsigned calculation");
+				throw std::runtime_error("BigUnsigned: Negative result in unsigned calculation");
 		}
 
 		return *this;
 	}
 
 	/// Multiplication compound assignment operator
-	BigUnsigned &BigUnsigned::operator *=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator *=(const BigUnsigned &rhs)
 	{
 		if (*this) // check if not zero
 		{
-			// things would mess up pretty badly if
-			// they are the exact same data (a *= a)
-			// so makes sure it's not the same before
-			// multiplying
-			if (this != &rhs)
-			{
-				if (rhs) // check if not zero
-					multiply(rhs); // multiply this by rhs
-				else
-					clearData(); // anything multiplied by zero is zero
-			}
+			if (rhs) // check if not zero
+				multiply(rhs); // multiply this by rhs (this works even when rhs is this)
 			else
-			{
-				// this and rhs is the exact same data so
-				// this creates a temporary BigUnsigned
-				// using rhs and then multiplies them
-				// together
-				multiply(BigUnsigned(rhs));
-			}
+				clearData(); // anything multiplied by zero is zero
 		}
 
 		return *this;
 	}
 
 	/// Division compound assignment operator
-	BigUnsigned &BigUnsigned::operator /=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator /=(const BigUnsigned &rhs)
 	{
 		// divideWithRemainder does all the checking
 		// needed so just call the function
@@ -142,7 +167,7 @@ namespace BigNumber
 	}
 
 	/// Modulo compound assignment operator
-	BigUnsigned &BigUnsigned::operator %=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator %=(const BigUnsigned &rhs)
 	{
 		// the return value of divideWithRemainder is
 		// the remainder so just call the function and
@@ -151,7 +176,7 @@ namespace BigNumber
 	}
 
 	/// Bitwise AND compound assignment operator
-	BigUnsigned &BigUnsigned::operator &=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator &=(const BigUnsigned &rhs)
 	{
 		if (*this) // check if not zero
 		{
@@ -165,7 +190,7 @@ namespace BigNumber
 	}
 
 	/// Bitwise OR compound assignment operator
-	BigUnsigned &BigUnsigned::operator |=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator |=(const BigUnsigned &rhs)
 	{
 		if (rhs) // check if not zero
 		{
@@ -179,7 +204,7 @@ namespace BigNumber
 	}
 
 	/// Bitwise XOR compound assignment operator
-	BigUnsigned &BigUnsigned::operator ^=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator ^=(const BigUnsigned &rhs)
 	{
 		if (rhs) // check if not zero
 		{
@@ -193,7 +218,7 @@ namespace BigNumber
 	}
 
 	/// Bitshift left compound assignment operator
-	BigUnsigned &BigUnsigned::operator <<=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator <<=(const BigUnsigned &rhs)
 	{
 		if (*this && rhs) // make sure both this and rhs is not zero
 			bitShiftLeft(rhs); // this function does the rest
@@ -202,7 +227,7 @@ namespace BigNumber
 	}
 
 	/// Bitshift right compound assignment operator
-	BigUnsigned &BigUnsigned::operator >>=(const BigUnsigned &rhs)
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator >>=(const BigUnsigned &rhs)
 	{
 		if (*this && rhs) // make sure both this and rhs is not zero
 			bitShiftRight(rhs); // this function does the rest
@@ -211,231 +236,474 @@ namespace BigNumber
 	}
 
 	/// Bitwise NOT
-	BigUnsigned BigUnsigned::operator ~() const
+	BIGNUMBER_INLINE BigUnsigned BigUnsigned::operator ~() const
 	{
-		BigUnsigned val(*this); // return value with copy of this
+		BigUnsigned val; // return value
 
-		if (val) // check if not zero
+		if (*this) // check if not zero
 		{
-			val.makeDataUnique(); // make the data unique so we can mess with it
-			for (auto &data : *val.pData) // loop through every item
-				data = ~data; // invert the data
+			BIGNUMBER_COUNT_OPERATION(Bitwise, pData->size());
+
+			// get a buffer the same size and invert the data into it
+			val.pData = BigUnsignedPool::acquire(pData->size());
+			val.pData->resize(pData->size());
+			Kernels::notN(val.pData->data(), pData->data(), pData->size());
+
+			// remove possible leading zeros
+			val.removeLeadingZeros();
 		}
 
-		return move(val);
+		return std::move(val);
 	}
 
 	/// Prefix increment
-	BigUnsigned &BigUnsigned::operator ++()
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator ++()
 	{
-		return operator +=(1);
+		if (*this) // check if not zero
+		{
+			// get the data ready to be modified with room for a carry
+			reserveData(pData->size() + 1);
+
+			// add one and insert the carry if there is one
+			if (Kernels::add1(pData->data(), pData->data(), pData->size(), 1) != 0)
+				pData->push_back(1);
+		}
+		else
+			operator =(true); // zero plus one is one
+
+		return *this;
 	}
 
 	/// Prefix decrement
-	BigUnsigned &BigUnsigned::operator --()
+	BIGNUMBER_INLINE BigUnsigned &BigUnsigned::operator --()
 	{
-		return operator -=(1);
+		if (!*this) // check if zero
+			throw std::runtime_error("BigUnsigned: Negative result in unsigned calculation");
+
+		// get the data ready to be modified
+		makeDataUnique();
+
+		// subtract one and remove the possible leading zero
+		Kernels::sub1(pData->data(), pData->data(), pData->size(), 1);
+		removeLeadingZeros();
+
+		return *this;
 	}
 
 	/// Postfix increment
-	BigUnsigned BigUnsigned::operator ++(int)
+	BIGNUMBER_INLINE BigUnsigned BigUnsigned::operator ++(int)
 	{
 		BigUnsigned temp(*this);
 		operator ++();
-		return move(temp);
+		return std::move(temp);
 	}
 
 	/// Postfix decrement
-	BigUnsigned BigUnsigned::operator --(int)
+	BIGNUMBER_INLINE BigUnsigned BigUnsigned::operator --(int)
 	{
 		BigUnsigned temp(*this);
 		operator --();
-		return move(temp);
+		return std::move(temp);
 	}
 
-	// clearData safely sets the data to zero
-	void BigUnsigned::clearData()
+	/// Reserve room for a number of items so the data doesn't have to grow
+	BIGNUMBER_INLINE void BigUnsigned::reserve(size_t size)
 	{
-		if (pData.unique()) // check if the data is unique
-			pData->clear(); // clear it using the data's member function
+		reserveData(size);
+	}
+
+	/// Number of items the current buffer can hold without growing
+	BIGNUMBER_INLINE size_t BigUnsigned::capacity() const
+	{
+		if (pData) // check if not nullptr
+			return pData->capacity();
 		else
-			pData = make_shared<colType>(); // make a new shared pointer since it's not unique
+			return 0;
 	}
 
-	// makeDataUnique makes the data unique so the data can be safely messed with
-	void BigUnsigned::makeDataUnique()
+	/// Free the room that isn't being used
+	BIGNUMBER_INLINE void BigUnsigned::shrinkToFit()
 	{
-		if (!pData.unique()) // check if the data is not unique
+		// shared data is left alone since other values are using it
+		if (isDataUnique())
 		{
-			if (pData) // check if the pointer is not a nullptr
-				pData = make_shared<colType>(*pData); // make a new shared pointer with the data copied
+			if (pData->empty())
+				releaseData(); // zero doesn't need a buffer at all
 			else
-				pData = make_shared<colType>(); // make a new shared pointer
+				pData->shrink_to_fit();
 		}
 	}
 
-	// removeLeadingZeros does exactly what it sounds like
-	void BigUnsigned::removeLeadingZeros()
+	/// Three-way comparison
+	BIGNUMBER_INLINE int BigUnsigned::compare(const BigUnsigned &rhs) const
+	{
+		if (pData == rhs.pData)
+			return 0; // the pointers are the same so the data is the same
+
+		// a nullptr is zero, the same as an empty collection
+		const size_t size = pData ? pData->size() : 0, rSize = rhs.pData ? rhs.pData->size() : 0;
+
+		// there aren't any leading zeros so the longer one is bigger
+		if (size != rSize)
+			return size < rSize ? -1 : 1;
+
+		return size != 0 ? Kernels::compare(pData->data(), rhs.pData->data(), size) : 0;
+	}
+
+	/// Hash of the value
+	BIGNUMBER_INLINE size_t BigUnsigned::hash() const
 	{
-		while (!pData->empty()) // loop until empty or break is called
+		// each item is mixed into the state with a multiply (which moves bits up)
+		// and a shift (which moves them back down), then the state is scrambled
+		// once at the end so every bit of the hash depends on every bit of the
+		// value (the finalizer is the one from MurmurHash3). there are never any
+		// leading zeros, so equal values always have the same items
+		uint64_t state = 0x9E3779B97F4A7C15;
+
+		if (pData) // check if not nullptr
 		{
-			if (pData->back() == 0)
-				pData->pop_back(); // the back is zero so remove the leading zero
-			else
-				break; // the back is not zero so exit
+			for (dataType item : *pData)
+			{
+				state = (state ^ item) * 0xBF58476D1CE4E5B9;
+				state ^= state >> 32;
+			}
 		}
+
+		state ^= state >> 33;
+		state *= 0xFF51AFD7ED558CCD;
+		state ^= state >> 33;
+		state *= 0xC4CEB9FE1A85EC53;
+		state ^= state >> 33;
+
+		return (size_t)state;
 	}
 
-	// addition helper function
-	void BigUnsigned::add(const BigUnsigned &rVal)
+	/// Check if a bit is set
+	BIGNUMBER_INLINE bool BigUnsigned::testBit(size_t bit) const
+	{
+		const size_t item = bit / dataTypeSize;
+
+		// bits past the end are leading zeros
+		if (!pData || item >= pData->size())
+			return false;
+
+		return (((*pData)[item] >> (bit % dataTypeSize)) & 1) != 0;
+	}
+
+	/// Set a bit
+	BIGNUMBER_INLINE void BigUnsigned::setBit(size_t bit)
+	{
+		// nothing changes if it's already set (and shared data doesn't get copied)
+		if (testBit(bit))
+			return;
+
+		const size_t item = bit / dataTypeSize;
+
+		// get the data ready to be modified with room for the item
+		reserveData(item + 1);
+
+		if (pData->size() <= item)
+			pData->resize(item + 1, 0);
+
+		(*pData)[item] |= (dataType)1 << (bit % dataTypeSize);
+	}
+
+	/// Clear a bit
+	BIGNUMBER_INLINE void BigUnsigned::clearBit(size_t bit)
 	{
+		// nothing changes if it's already clear
+		if (!testBit(bit))
+			return;
+
 		// get the data ready to be modified
 		makeDataUnique();
 
-		auto iter = begin(*rVal.pData); // iterator to beginning of rVal
-		bool carry = false; // the carry bit
+		(*pData)[bit / dataTypeSize] &= ~((dataType)1 << (bit % dataTypeSize));
+
+		// clearing the highest bit can leave leading zeros
+		removeLeadingZeros();
+	}
+
+	/// Flip a bit
+	BIGNUMBER_INLINE void BigUnsigned::flipBit(size_t bit)
+	{
+		if (testBit(bit))
+			clearBit(bit);
+		else
+			setBit(bit);
+	}
+
+	/// Number of bits without the leading zeros
+	BIGNUMBER_INLINE size_t BigUnsigned::bitLength() const
+	{
+		if (!*this) // check if zero
+			return 0;
+
+		return pData->size() * dataTypeSize - Kernels::leadingZeros(pData->back());
+	}
+
+	/// Number of set bits
+	BIGNUMBER_INLINE size_t BigUnsigned::popcount() const
+	{
+		if (!*this) // check if zero
+			return 0;
+
+		return Kernels::popcount(pData->data(), pData->size());
+	}
+
+	/// Number of zero bits below the lowest set bit
+	BIGNUMBER_INLINE size_t BigUnsigned::countTrailingZeros() const
+	{
+		return scanBit(0, true);
+	}
+
+	/// Position of the first bit at or after start with the value
+	BIGNUMBER_INLINE size_t BigUnsigned::scanBit(size_t start, bool value) const
+	{
+		const size_t size = pData ? pData->size() : 0;
+		size_t item = start / dataTypeSize;
+
+		// past the end every bit is a leading zero
+		if (item >= size)
+			return value ? npos : start;
+
+		// look for set bits (inverting the items when looking for a zero)
+		// after throwing away the bits of the first item below start
+		const dataType invert = value ? 0 : ~(dataType)0;
+		dataType bits = ((*pData)[item] ^ invert) & (~(dataType)0 << (start % dataTypeSize));
 
-		// loop through the data
-		for (auto &data : *pData)
+		while (bits == 0)
 		{
-			if (iter != end(*rVal.pData)) // check if the iterator didn't end
-			{
-				data += *iter; // add the data
+			if (++item == size)
+				return value ? npos : size * dataTypeSize; // the first leading zero
 
-				if (data < *iter) // check for overflow
-				{
-					// add one if there is a carry bit
-					if (carry)
-						++data;
+			bits = (*pData)[item] ^ invert;
+		}
 
-					carry = true; // because of overflow the next one has a carry bit
-				}
-				else if (carry)
-				{
-					++data; // add the carry bit
-					carry = (data == 0); // check if there is still overflow
-				}
+		return item * dataTypeSize + Kernels::trailingZeros(bits);
+	}
 
-				++iter; // increment the iterater
-			}
-			else if (carry)
+	// clearData safely sets the data to zero
+	BIGNUMBER_INLINE void BigUnsigned::clearData()
+	{
+		if (isDataUnique()) // check if the data is unique
+			pData->clear(); // clear it using the data's member function
+		else
+			pData = BigUnsignedPool::acquire(0); // get an empty buffer from the pool since it's not unique
+	}
+
+	// releaseData gives the data back to the pool (if it isn't shared) and sets this to zero
+	BIGNUMBER_INLINE void BigUnsigned::releaseData()
+	{
+		if (pData) // check if the pointer is not a nullptr
+			BigUnsignedPool::release(pData);
+	}
+
+	// makeDataUnique makes the data unique so the data can be safely messed with
+	BIGNUMBER_INLINE void BigUnsigned::makeDataUnique()
+	{
+		reserveData(0);
+	}
+
+	// reserveData makes the data unique with room for at least size items so
+	// the helper functions can size their results once before changing anything
+	BIGNUMBER_INLINE void BigUnsigned::reserveData(size_t size)
+	{
+		if (isDataUnique()) // check if the data is unique
+		{
+			if (pData->capacity() < size)
 			{
-				++data; // add the carry bit
-				carry = (data == 0); // check if there is still overflow
+				// the buffer is too small so move the data into
+				// a big enough buffer from the pool
+				auto newData = BigUnsignedPool::acquire(size);
+				newData->assign(std::begin(*pData), std::end(*pData));
+				BigUnsignedPool::release(pData);
+				pData = std::move(newData);
 			}
-			else
-				break; // nothing else to add so exit
 		}
+		else if (pData) // check if the pointer is not a nullptr
+		{
+			// get a buffer from the pool with the data copied
+			BIGNUMBER_COUNT_COPY(pData->size() * sizeof(dataType));
+			auto newData = BigUnsignedPool::acquire(std::max(size, pData->size()));
+			newData->assign(std::begin(*pData), std::end(*pData));
+			pData = std::move(newData);
+		}
+		else
+			pData = BigUnsignedPool::acquire(size); // get an empty buffer from the pool
+	}
 
-		// loop through the rest of rVal if this data ended before it did
-		for (; iter != end(*rVal.pData); ++iter)
+	// resetData throws away the data and makes sure there is a unique buffer with
+	// room for at least size items. the current buffer is used when it can be
+	BIGNUMBER_INLINE void BigUnsigned::resetData(size_t size)
+	{
+		if (isDataUnique() && pData->capacity() >= size)
+			pData->clear();
+		else
 		{
-			if (carry)
-			{
-				pData->push_back(*iter + 1); // insert the data and add the carry bit
-				carry = (pData->back() == 0); // check if there is still overflow
-			}
-			else
-			{
-				// there's nothing left to add so just insert
-				// the rest and exit this loop
-				pData->insert(end(*pData), iter, end(*rVal.pData));
-				break;
-			}
+			releaseData();
+			pData = BigUnsignedPool::acquire(size);
+		}
+	}
+
+	// removeLeadingZeros does exactly what it sounds like
+	BIGNUMBER_INLINE void BigUnsigned::removeLeadingZeros()
+	{
+		pData->resize(Kernels::normalizedSize(pData->data(), pData->size()));
+	}
+
+	// toSize sets value to this if it fits in a size_t and returns false if it doesn't
+	BIGNUMBER_INLINE bool BigUnsigned::toSize(size_t &value) const
+	{
+		value = 0;
+
+		if (*this) // check if not zero
+		{
+			if (pData->size() > 1 || pData->front() > std::numeric_limits<size_t>::max())
+				return false;
+
+			value = (size_t)pData->front();
 		}
 
-		// if there is an extra carry bit, then add it
-		if (carry)
+		return true;
+	}
+
+	// addBit adds two to the power of bit. the carry only goes through the items it changes
+	BIGNUMBER_INLINE void BigUnsigned::addBit(size_t bit)
+	{
+		const size_t item = bit / dataTypeSize;
+
+		// past the end it's the same as setting the bit
+		if (!pData || item >= pData->size())
+		{
+			setBit(bit);
+			return;
+		}
+
+		// get the data ready to be modified
+		makeDataUnique();
+
+		// add the bit and insert the carry if there is one
+		if (Kernels::add1(pData->data() + item, pData->data() + item, pData->size() - item, (dataType)1 << (bit % dataTypeSize)) != 0)
 			pData->push_back(1);
 	}
 
-	// subtraction helper function
-	void BigUnsigned::subtract(const BigUnsigned &rVal)
+	// subtractBit subtracts two to the power of bit (this can't be smaller than it)
+	BIGNUMBER_INLINE void BigUnsigned::subtractBit(size_t bit)
 	{
-		// this function uses two's compliment to subtract the two values so
-		// it will look a lot like the add function.
+		const size_t item = bit / dataTypeSize;
+
+		if (!pData || item >= pData->size())
+			throw std::runtime_error("BigUnsigned: Negative result in unsigned calculation");
 
 		// get the data ready to be modified
 		makeDataUnique();
 
-		auto iter = begin(*rVal.pData); // iterator to beginning of rVal
-		bool carry = true; // the carry bit
+		// subtract the bit and remove the possible leading zeros
+		Kernels::sub1(pData->data() + item, pData->data() + item, pData->size() - item, (dataType)1 << (bit % dataTypeSize));
+		removeLeadingZeros();
+	}
 
-		// loop through the data
-		for (auto &data : *pData)
-		{
-			if (iter != end(*rVal.pData)) // check if the iterator didn't end
-			{
-				data += ~*iter; // add the inverse of the data
+	// addition helper function
+	BIGNUMBER_INLINE void BigUnsigned::add(const BigUnsigned &rVal)
+	{
+		// the sum has at most one more item than the biggest value
+		const size_t size = pData->size(), rSize = rVal.pData->size();
+		const size_t maxSize = std::max(size, rSize);
+		BIGNUMBER_COUNT_OPERATION(Add, maxSize);
+
+		// get the data ready to be modified. rVal's data is used after
+		// this in case rVal is this
+		reserveData(maxSize + 1);
+		pData->resize(maxSize + 1);
+
+		dataType *data = pData->data();
+		const dataType *rData = rVal.pData->data();
+
+		// the kernel needs the longer value first
+		if (size >= rSize)
+			data[maxSize] = Kernels::add(data, data, size, rData, rSize);
+		else
+			data[maxSize] = Kernels::add(data, rData, rSize, data, size);
 
-				if (data < ~*iter) // check for overflow
-				{
-					// add one if there is a carry bit
-					if (carry)
-						++data;
+		// remove the extra item if there was no carry
+		if (data[maxSize] == 0)
+			pData->pop_back();
+	}
 
-					carry = true; // because of overflow the next one has a carry bit
-				}
-				else if (carry)
-				{
-					++data; // add the carry bit
-					carry = (data == 0); // check if there is still overflow
-				}
+	// subtraction helper function
+	BIGNUMBER_INLINE void BigUnsigned::subtract(const BigUnsigned &rVal)
+	{
+		// this should always be bigger than rVal so the difference
+		// always fits in this data
+		BIGNUMBER_COUNT_OPERATION(Subtract, pData->size());
 
-				++iter; // increment the iterater
-			}
-			else if (!carry)
-			{
-				data += ~(dataType)0; // add the inverse of the data
-				carry = (data < ~(dataType)0); // check if there is still overflow
-			}
-			else
-				break; // nothing else to add so exit
-		}
+		// get the data ready to be modified
+		makeDataUnique();
+
+		Kernels::sub(pData->data(), pData->data(), pData->size(), rVal.pData->data(), rVal.pData->size());
+
+		// remove possible leading zeros
+		removeLeadingZeros();
+	}
+
+	// reverse subtraction helper function (this = rVal - this)
+	BIGNUMBER_INLINE void BigUnsigned::reverseSubtract(const BigUnsigned &rVal)
+	{
+		// rVal should always be bigger than this so the difference
+		// always fits in rVal's size
+		const size_t size = pData->size(), rSize = rVal.pData->size();
+		BIGNUMBER_COUNT_OPERATION(Subtract, rSize);
+
+		// get the data ready to be modified
+		reserveData(rSize);
+		pData->resize(rSize);
 
-		// After subtraction with two's compliment, the most significant bit
-		// bit should be removed. But since this should always be bigger than
-		// rVal; carry should always be true after the above loop finishes,
-		// so just ignore the extra carry bit.
+		// the kernel reads each item of this before writing it
+		Kernels::sub(pData->data(), rVal.pData->data(), rSize, pData->data(), size);
 
 		// remove possible leading zeros
 		removeLeadingZeros();
 	}
 
 	// multiplication helper function
-	void BigUnsigned::multiply(const BigUnsigned &rVal)
+	BIGNUMBER_INLINE void BigUnsigned::multiply(const BigUnsigned &rVal)
 	{
-		// this function uses the shift and add technique to multiply the values
+		// the kernel picks the method (schoolbook or Karatsuba) from the sizes.
+		// the product has at most as many items as both values together so the
+		// results get a buffer that size before anything is done
 
-		BigUnsigned results, shiftAmount;
+		const size_t size = pData->size(), rSize = rVal.pData->size();
 
-		// loop through rVal
-		for (const auto &data : *rVal.pData)
-		{
-			// loop through each bit
-			for (dataType bitToGet = 1; bitToGet != 0; bitToGet <<= 1)
-			{
-				// shift and add if the current bit is set
-				if ((data & bitToGet) != 0)
-				{
-					operator <<=(shiftAmount); // shift
-					results += *this; // add
-					shiftAmount.clearData(); // reset the shift amount
-				}
+		if (pData == rVal.pData)
+			BIGNUMBER_COUNT_OPERATION(Square, size);
+		else
+			BIGNUMBER_COUNT_OPERATION(Multiply, std::max(size, rSize));
 
-				++shiftAmount; // increment the shift amount
-			}
-		}
+		auto results = BigUnsignedPool::acquire(size + rSize);
+		results->resize(size + rSize);
+
+		// the kernel needs the longer value first
+		if (size >= rSize)
+			Kernels::mul(results->data(), pData->data(), size, rVal.pData->data(), rSize);
+		else
+			Kernels::mul(results->data(), rVal.pData->data(), rSize, pData->data(), size);
 
 		// move the results into this
-		*this = move(results);
+		releaseData();
+		pData = std::move(results);
+
+		// remove possible leading zeros
+		removeLeadingZeros();
 	}
 
 	// division and modulus helper function
-	BigUnsigned BigUnsigned::divideWithRemainder(const BigUnsigned &rVal)
+	BIGNUMBER_INLINE BigUnsigned BigUnsigned::divideWithRemainder(const BigUnsigned &rVal)
 	{
 		if (!rVal) // check if zero
-			throw invalid_argument("BigUnsigned: cannot divide by zero");
+			throw std::invalid_argument("BigUnsigned: cannot divide by zero");
+
+		BIGNUMBER_COUNT_OPERATION(Divide, pData ? pData->size() : 0);
 
 		// this is what gets returned
 		BigUnsigned remainder;
@@ -448,197 +716,194 @@ namespace BigNumber
 			pData->push_back(1);
 		}
 		else if (*this < rVal) // check if this is less than rVal
-			remainder = move(*this); // the results is zero and the remainder is this
+			remainder = std::move(*this); // the results is zero and the remainder is this
+		else if (rVal.pData->size() == 1)
+		{
+			// dividing by a single item can be done in place
+			BIGNUMBER_TIME_ALGORITHM(BigInstrumentation::Algorithm::LimbDivision);
+			const dataType divisor = rVal.pData->front();
+
+			makeDataUnique();
+			const dataType rest = Kernels::divRem1(pData->data(), pData->data(), pData->size(), divisor);
+
+			// remove possible leading zeros
+			removeLeadingZeros();
+
+			if (rest != 0)
+				remainder = rest;
+		}
 		else
 		{
-			dataType bit = (dataType)1 << (dataTypeSize - 1); // the current bit set to the left most bit
-			BigUnsigned results;
+			// the quotient has at most the difference of the sizes plus one
+			// items and the remainder has at most as many items as rVal, so
+			// both get a buffer that size. the kernel also needs room to
+			// work with copies of both values
+			BIGNUMBER_TIME_ALGORITHM(BigInstrumentation::Algorithm::KnuthDivision);
+			const size_t size = pData->size(), rSize = rVal.pData->size();
 
-			// loop until the bit is the most significant bit of this
-			while ((pData->back() & bit) == 0)
-				bit >>= 1; // get the next bit
+			auto results = BigUnsignedPool::acquire(size - rSize + 1);
+			auto scratch = BigUnsignedPool::acquire(size + rSize + 1);
+			remainder.pData = BigUnsignedPool::acquire(rSize);
 
-			// loop through the data
-			for (auto iter = rbegin(*pData); iter != rend(*pData); ++iter)
-			{
-				// this uses a shift and subtract technique to divide the two values
-				
-				// loop through each bit
-				for (; bit != 0; bit >>= 1)
-				{
-					// check if the remainder is bigger than rVal
-					if (remainder >= rVal)
-					{
-						++results; // increment the results
-						remainder -= rVal; // subtract rVal from remainder
-					}
-
-					// shift the results and remainder to the left by one
-					results <<= 1;
-					remainder <<= 1;
-
-					// the new remainder bit recieved by shifting is
-					// set to the value of the current bit
-					if ((*iter & bit) != 0)
-						++remainder;
-				}
+			results->resize(size - rSize + 1);
+			scratch->resize(size + rSize + 1);
+			remainder.pData->resize(rSize);
 
-				// reset the current bit to the left most bit
-				bit = (dataType)1 << (dataTypeSize - 1);
-			}
+			Kernels::divRem(results->data(), remainder.pData->data(), pData->data(), size, rVal.pData->data(), rSize, scratch->data());
 
-			// check if the remainder is bigger than rVal
-			if (remainder >= rVal)
-			{
-				++results; // increment the results
-				remainder -= rVal; // subtract rVal from remainder
-			}
+			// the scratch buffer isn't needed anymore
+			BigUnsignedPool::release(scratch);
 
 			// move the results into this
-			operator =(move(results));
+			releaseData();
+			pData = std::move(results);
+
+			// remove possible leading zeros
+			removeLeadingZeros();
+			remainder.removeLeadingZeros();
 		}
 
 		// return the remainder
-		return move(remainder);
+		return std::move(remainder);
 	}
 
 	// bitwise AND helper function
-	void BigUnsigned::bitAND(const BigUnsigned &rVal)
+	BIGNUMBER_INLINE void BigUnsigned::bitAND(const BigUnsigned &rVal)
 	{
+		// the results can't be longer than the shortest value
+		const size_t size = std::min(pData->size(), rVal.pData->size());
+		BIGNUMBER_COUNT_OPERATION(Bitwise, size);
+
 		// get the data ready to be modified
 		makeDataUnique();
 
-		auto lIter = begin(*pData); // iterator to beginning of this data
-
-		// loop through until one ends
-		for (auto rIter = begin(*rVal.pData); lIter != end(*pData) && rIter != end(*rVal.pData); ++lIter, ++rIter)
-			*lIter &= *rIter;
+		Kernels::andN(pData->data(), pData->data(), rVal.pData->data(), size);
 
 		// erase whats left over if rVal ended first
-		pData->erase(lIter, end(*pData));
+		pData->resize(size);
 
 		// remove possible leading zeros
 		removeLeadingZeros();
 	}
 
 	// bitwise OR helper function
-	void BigUnsigned::bitOR(const BigUnsigned &rVal)
+	BIGNUMBER_INLINE void BigUnsigned::bitOR(const BigUnsigned &rVal)
 	{
+		// the results are as long as the longest value
+		const size_t size = pData->size(), rSize = rVal.pData->size();
+		BIGNUMBER_COUNT_OPERATION(Bitwise, std::max(size, rSize));
+
 		// get the data ready to be modified
-		makeDataUnique();
+		reserveData(std::max(size, rSize));
 
-		auto rIter = begin(*rVal.pData); // iterator to beginning of rVal's data
+		const dataType *rData = rVal.pData->data();
 
-		// loop until one ends
-		for (auto lIter = begin(*pData); lIter != end(*pData) && rIter != end(*rVal.pData); ++lIter, ++rIter)
-			*lIter |= *rIter;
+		Kernels::orN(pData->data(), pData->data(), rData, std::min(size, rSize));
 
 		// insert whats left over if this ended first
-		pData->insert(end(*pData), rIter, end(*rVal.pData));
+		if (rSize > size)
+			pData->insert(std::end(*pData), rData + size, rData + rSize);
 	}
 
 	// bitwise XOR helper function
-	void BigUnsigned::bitXOR(const BigUnsigned &rVal)
+	BIGNUMBER_INLINE void BigUnsigned::bitXOR(const BigUnsigned &rVal)
 	{
+		// the results are at most as long as the longest value
+		const size_t size = pData->size(), rSize = rVal.pData->size();
+		BIGNUMBER_COUNT_OPERATION(Bitwise, std::max(size, rSize));
+
 		// get the data ready to be modified
-		makeDataUnique();
+		reserveData(std::max(size, rSize));
 
-		auto rIter = begin(*rVal.pData); // iterator to beginning of rVal's data
+		const dataType *rData = rVal.pData->data();
 
-		// loop until one ends
-		for (auto lIter = begin(*pData); lIter != end(*pData) && rIter != end(*rVal.pData); ++lIter, ++rIter)
-			*lIter ^= *rIter;
+		Kernels::xorN(pData->data(), pData->data(), rData, std::min(size, rSize));
 
 		// insert whats left over if this ended first
-		pData->insert(end(*pData), rIter, end(*rVal.pData));
+		if (rSize > size)
+			pData->insert(std::end(*pData), rData + size, rData + rSize);
 
 		// remove possible leading zeros
 		removeLeadingZeros();
 	}
 
 	// bitshift left helper function
-	void BigUnsigned::bitShiftLeft(BigUnsigned rVal)
+	BIGNUMBER_INLINE void BigUnsigned::bitShiftLeft(const BigUnsigned &rVal)
 	{
+		size_t amount;
+
+		if (!rVal.toSize(amount))
+			throw std::length_error("BigUnsigned: Value is too big to shift left");
+
+		// the number of items to add in the front and the number of bits to shift left over
+		const size_t numOfItems = amount / dataTypeSize;
+		const unsigned int numOfBits = (unsigned int)(amount % dataTypeSize);
+
+		// the results have at most one more item than the shifted items
+		const size_t size = pData->size();
+		BIGNUMBER_COUNT_OPERATION(Shift, size);
+
 		// get the data ready to be modified
-		makeDataUnique();
+		reserveData(size + numOfItems + 1);
+		pData->resize(size + numOfItems + 1);
 
-		// use the function divideWithRemainder so that rVal gets
-		// the number of times to add a zero in the front and the
-		// remainder is the number of bits to shift left over
-		const size_t numOfBits = (size_t)rVal.divideWithRemainder(dataTypeSize);
+		dataType *data = pData->data();
 
-		// insert zeros to the front of the data
-		if (rVal && rVal.pData->size() == 1)
-			pData->insert(begin(*pData), rVal.pData->front(), 0);
+		// move the data up and put the bits shifted out at the end
+		if (numOfBits != 0)
+			data[size + numOfItems] = Kernels::lshift(data + numOfItems, data, size, numOfBits);
 		else
 		{
-			// loop until zero
-			for (; rVal; --rVal)
-				pData->push_front(0);
+			std::copy_backward(data, data + size, data + size + numOfItems);
+			data[size + numOfItems] = 0;
 		}
 
-		// it won't do anything if it's shifted zero bits
-		if (numOfBits != 0)
-		{
-			// the new data to set and the bits carried from the previous data
-			dataType newData, carriedBits = 0;
+		// fill the front with zeros
+		std::fill(data, data + numOfItems, 0);
 
-			// loop through the data
-			for (auto &data : *pData)
-			{
-				newData = carriedBits | (data << numOfBits); // get the new data
-				carriedBits = data >> (dataTypeSize - numOfBits); // get the bits to carry
-				data = newData; // set the new data
-			}
-
-			// add one at the end if there are any carried bits
-			if (carriedBits != 0)
-				pData->push_back(carriedBits);
-		}
+		// remove the extra item if there were no bits shifted out
+		if (pData->back() == 0)
+			pData->pop_back();
 	}
 
 	// bitshift right helper function
-	void BigUnsigned::bitShiftRight(BigUnsigned rVal)
+	BIGNUMBER_INLINE void BigUnsigned::bitShiftRight(const BigUnsigned &rVal)
 	{
-		// get the data ready to be modified
-		makeDataUnique();
-
-		// use the function divideWithRemainder so that rVal gets
-		// the number of times to remove an item from the front and
-		// the remainder is the number of bits to shift left over
-		const size_t numOfBits = (size_t)rVal.divideWithRemainder(dataTypeSize);
+		size_t amount;
+		BIGNUMBER_COUNT_OPERATION(Shift, pData->size());
 
-		// loop until zero or break is called
-		for (; rVal; --rVal)
+		// shifting by more than there are bits makes it zero
+		if (!rVal.toSize(amount) || amount / dataTypeSize >= pData->size())
 		{
-			// make sure it's not empty before trying to remove one
-			if (!pData->empty())
-				pData->pop_front(); // remove the front item
-			else
-				break; // exit the loop
+			clearData();
+			return;
 		}
 
-		// make sure the data isn't empty and there are bits to be shifted
-		if (!pData->empty() && numOfBits != 0)
-		{
-			// the new data to set and the bits carried from the previous data
-			dataType newData, carriedBits = 0;
+		// the number of items to remove from the front and the number of bits to shift left over
+		const size_t numOfItems = amount / dataTypeSize;
+		const unsigned int numOfBits = (unsigned int)(amount % dataTypeSize);
+		const size_t size = pData->size() - numOfItems;
 
-			// loop through the data backwards
-			for (auto iter = rbegin(*pData); iter != rend(*pData); ++iter)
-			{
-				newData = carriedBits | (*iter >> numOfBits); // get the new data
-				carriedBits = *iter << (dataTypeSize - numOfBits); // get the bits to carry
-				*iter = newData; // set the new data
-			}
+		// get the data ready to be modified
+		makeDataUnique();
 
-			// remove possible leading zeros
-			removeLeadingZeros();
-		}
+		dataType *data = pData->data();
+
+		// move the data down
+		if (numOfBits != 0)
+			Kernels::rshift(data, data + numOfItems, size, numOfBits);
+		else
+			std::copy(data + numOfItems, data + numOfItems + size, data);
+
+		// erase the items that were shifted out
+		pData->resize(size);
+
+		// remove possible leading zeros
+		removeLeadingZeros();
 	}
 
 	/// Equal to operator
-	bool operator ==(const BigUnsigned &lhs, const BigUnsigned &rhs)
+	BIGNUMBER_INLINE bool operator ==(const BigUnsigned &lhs, const BigUnsigned &rhs)
 	{
 		if (lhs.pData == rhs.pData)
 			return true; // the pointers are the same so the data is the same
@@ -658,29 +923,216 @@ namespace BigNumber
 	}
 
 	/// Less than operator
-	bool operator <(const BigUnsigned &lhs, const BigUnsigned &rhs)
+	BIGNUMBER_INLINE bool operator <(const BigUnsigned &lhs, const BigUnsigned &rhs)
 	{
-		if (lhs.pData == rhs.pData)
-			return false; // the pointers are the same so the data is the same
+		return lhs.compare(rhs) < 0;
+	}
 
-		if (lhs.pData && rhs.pData) // check if both pointers point to something
+	/// Three-address addition (out = a + b)
+	BIGNUMBER_INLINE void add(BigUnsigned &out, const BigUnsigned &a, const BigUnsigned &b)
+	{
+		if (&out == &a)
+			out += b; // add b into out
+		else if (&out == &b)
+			out += a; // add a into out
+		else if (!a || !b)
+			out = a ? a : b; // one of them is zero so just copy the other one
+		else
+		{
+			// the kernel needs the longer value first
+			const BigUnsigned &big = a.pData->size() >= b.pData->size() ? a : b;
+			const BigUnsigned &small = &big == &a ? b : a;
+			const size_t size = big.pData->size(), smallSize = small.pData->size();
+
+			BIGNUMBER_COUNT_OPERATION(Add, size);
+
+			// reuse out's buffer with room for the carry
+			out.resetData(size + 1);
+			out.pData->resize(size + 1);
+
+			out.pData->back() = Kernels::add(out.pData->data(), big.pData->data(), size, small.pData->data(), smallSize);
+
+			// remove the extra item if there was no carry
+			if (out.pData->back() == 0)
+				out.pData->pop_back();
+		}
+	}
+
+	/// Three-address subtraction (out = a - b)
+	BIGNUMBER_INLINE void sub(BigUnsigned &out, const BigUnsigned &a, const BigUnsigned &b)
+	{
+		if (a < b)
+			throw std::runtime_error("BigUnsigned: Negative result in unsigned calculation");
+
+		if (!b)
+			out = a; // subtracting zero doesn't change anything
+		else if (a == b)
+			out.clearData(); // subtracting two of the same value returns zero
+		else if (&out == &a)
+			out.subtract(b); // subtract b from out
+		else if (&out == &b)
+			out.reverseSubtract(a); // subtract out from a
+		else
 		{
-			if (lhs.pData->size() != rhs.pData->size()) // check if they are different sizes
-				return (lhs.pData->size() < rhs.pData->size()); // return true if the lhs data's size is smaller
+			const size_t size = a.pData->size();
+			BIGNUMBER_COUNT_OPERATION(Subtract, size);
+
+			// reuse out's buffer with room for a's size
+			out.resetData(size);
+			out.pData->resize(size);
+
+			Kernels::sub(out.pData->data(), a.pData->data(), size, b.pData->data(), b.pData->size());
 
-			// compare the two and returns true if the lhs data is smaller
-			return lexicographical_compare(rbegin(*lhs.pData), rend(*lhs.pData), rbegin(*rhs.pData), rend(*rhs.pData));
+			// remove possible leading zeros
+			out.removeLeadingZeros();
 		}
+	}
+
+	/// Three-address multiplication (out = a * b)
+	BIGNUMBER_INLINE void mul(BigUnsigned &out, const BigUnsigned &a, const BigUnsigned &b)
+	{
+		if (!a || !b)
+			out.clearData(); // anything multiplied by zero is zero
+		else if (&out == &a)
+			out.multiply(b); // multiply out by b (this works even when b is out)
+		else if (&out == &b)
+			out.multiply(a); // multiply out by a
 		else
 		{
-			// one of the two pointers is nullptr so only return
-			// true if the lhs pointer is nullptr and the rhs
-			// pointer's collection is not empty
+			// the kernel needs the longer value first
+			const BigUnsigned &big = a.pData->size() >= b.pData->size() ? a : b;
+			const BigUnsigned &small = &big == &a ? b : a;
+			const size_t size = big.pData->size(), smallSize = small.pData->size();
 
-			if (!lhs.pData)
-				return !rhs.pData->empty();
+			if (a.pData == b.pData)
+				BIGNUMBER_COUNT_OPERATION(Square, size);
 			else
-				return false;
+				BIGNUMBER_COUNT_OPERATION(Multiply, size);
+
+			// reuse out's buffer with room for the product
+			out.resetData(size + smallSize);
+			out.pData->resize(size + smallSize);
+
+			Kernels::mul(out.pData->data(), big.pData->data(), size, small.pData->data(), smallSize);
+
+			// remove possible leading zeros
+			out.removeLeadingZeros();
+		}
+	}
+
+	/// Three-address multiply and add (out += a * b)
+	BIGNUMBER_INLINE void addmul(BigUnsigned &out, const BigUnsigned &a, const BigUnsigned &b)
+	{
+		if (!a || !b)
+			return; // adding zero doesn't change anything
+
+		if (!out)
+		{
+			// out is zero so this is just a multiplication
+			mul(out, a, b);
+			return;
+		}
+
+		if (&out == &a || &out == &b)
+		{
+			// out is one of the inputs so the product can't be added
+			// in place. the temporary's buffer comes from the pool
+			BigUnsigned product;
+			mul(product, a, b);
+			out += product;
+			return;
+		}
+
+		// the kernel needs the longer value first
+		const BigUnsigned &big = a.pData->size() >= b.pData->size() ? a : b;
+		const BigUnsigned &small = &big == &a ? b : a;
+		const size_t size = big.pData->size(), smallSize = small.pData->size();
+
+		BIGNUMBER_COUNT_OPERATION(Multiply, size);
+
+		// the sum has at most one more item than the biggest of out and the product
+		const size_t outSize = out.pData->size();
+		const size_t newSize = std::max(outSize, size + smallSize) + 1;
+
+		// get out ready to be modified
+		out.reserveData(newSize);
+		out.pData->resize(newSize);
+
+		BigUnsigned::dataType *data = out.pData->data();
+		const Kernels::Thresholds thresholds = Kernels::thresholds();
+
+		if (smallSize >= (a.pData == b.pData ? thresholds.square : thresholds.multiply))
+		{
+			// adding a row at a time is schoolbook multiplication, so above the threshold
+			// the product is worked out on its own and added. its buffer comes from the pool
+			BigUnsigned product;
+			product.resetData(size + smallSize);
+			product.pData->resize(size + smallSize);
+			Kernels::mul(product.pData->data(), big.pData->data(), size, small.pData->data(), smallSize);
+			Kernels::add(data, data, newSize, product.pData->data(), size + smallSize);
+		}
+		else
+		{
+			// add one row of the product at a time and carry into the rest of out
+			for (size_t i = 0; i < smallSize; ++i)
+			{
+				const BigUnsigned::dataType carry = Kernels::addmul1(data + i, big.pData->data(), size, small.pData->data()[i]);
+				Kernels::add1(data + i + size, data + i + size, newSize - i - size, carry);
+			}
 		}
+
+		// remove possible leading zeros
+		out.removeLeadingZeros();
+	}
+
+	/// Three-address multiply and subtract (out -= a * b)
+	BIGNUMBER_INLINE void submul(BigUnsigned &out, const BigUnsigned &a, const BigUnsigned &b)
+	{
+		if (!a || !b)
+			return; // subtracting zero doesn't change anything
+
+		// the product is needed to check the results won't be negative before
+		// out is changed. the temporary's buffer comes from the pool
+		BigUnsigned product;
+		mul(product, a, b);
+		out -= product;
+	}
+
+	/// Three-address division (out = a / b)
+	BIGNUMBER_INLINE void div(BigUnsigned &out, const BigUnsigned &a, const BigUnsigned &b)
+	{
+		if (&out == &b)
+		{
+			// out is the divisor so it can't be changed until the end
+			BigUnsigned quotient(a);
+			quotient.divideWithRemainder(b);
+			out = std::move(quotient);
+		}
+		else
+		{
+			out = a; // this only shares a's data
+			out.divideWithRemainder(b);
+		}
+	}
+
+	/// Three-address modulus (out = a % b)
+	BIGNUMBER_INLINE void mod(BigUnsigned &out, const BigUnsigned &a, const BigUnsigned &b)
+	{
+		BigUnsigned quotient(a); // this only shares a's data
+		out = quotient.divideWithRemainder(b);
+	}
+
+	/// Three-address division with remainder (q = a / b and r = a % b)
+	BIGNUMBER_INLINE void divMod(BigUnsigned &q, BigUnsigned &r, const BigUnsigned &a, const BigUnsigned &b)
+	{
+		if (&q == &r)
+			throw std::invalid_argument("BigUnsigned: the quotient and remainder must be different values");
+
+		BigUnsigned quotient(a); // this only shares a's data
+		BigUnsigned remainder = quotient.divideWithRemainder(b);
+
+		// a and b aren't needed anymore so it's safe to change q and r
+		q = std::move(quotient);
+		r = std::move(remainder);
 	}
 } // namespace BigNumber
@@ -26,36 +26,115 @@ Email address: weston925@gmail.com
 #ifndef BIGUNSIGNED_H
 #define BIGUNSIGNED_H
 
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGUNSIGNED_H_SOURCES
+#endif
+
 #include <memory>
-#include <deque>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <cstring>
+#include <iterator>
+#include <functional>
+#include "BigDataPtr.h"
+#include "BigKernels.h"
+
+// the <=> operators are only there when the compiler supports them (C++20)
+#if defined(__cpp_impl_three_way_comparison) && __cpp_impl_three_way_comparison >= 201907L
+#include <compare>
+#define BIGNUMBER_THREE_WAY_COMPARISON
+#endif
+
+// The data of a BigUnsigned is shared between copies and only copied when one
+// of them is changed. By default the sharing uses std::shared_ptr, which is safe
+// to copy between threads but makes every copy and destruction do an atomic
+// operation on the count. Defining one of these when building the library and
+// everything that uses it changes that:
+//
+// BIGNUMBER_SINGLE_THREADED: the data is still shared but the count isn't atomic,
+//                            so values can't be used from more than one thread (and
+//                            BigThreadPool always uses just the calling thread).
+// BIGNUMBER_VALUE_SEMANTICS: the data is never shared; copies copy the data and
+//                            moves are the only way to avoid the copy.
+#if defined(BIGNUMBER_SINGLE_THREADED) && defined(BIGNUMBER_VALUE_SEMANTICS)
+#error "BIGNUMBER_SINGLE_THREADED and BIGNUMBER_VALUE_SEMANTICS cannot both be defined"
+#endif
 
 namespace BigNumber
 {
 	/// Required declarations of classes and functions
 	class BigIntegerUtil;
+	class BigUnsignedPool;
 	class BigUnsigned;
 	class BigInteger;
+	enum class OverflowMode;
+	template <size_t, bool, OverflowMode> class BigFixed;
 	bool operator ==(const BigUnsigned &, const BigUnsigned &);
 	bool operator <(const BigUnsigned &, const BigUnsigned &);
 
+	/// Three-address arithmetic
+	//
+	// These write the results into the first argument (the output) instead of
+	// returning a new value, so the output's buffer gets reused. The output can
+	// be one of the inputs.
+	//
+	// add(out, a, b)         out = a + b
+	// sub(out, a, b)         out = a - b
+	// mul(out, a, b)         out = a * b
+	// addmul(out, a, b)      out += a * b
+	// submul(out, a, b)      out -= a * b
+	// div(out, a, b)         out = a / b
+	// mod(out, a, b)         out = a % b
+	// divMod(q, r, a, b)     q = a / b and r = a % b
+	void add(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+	void sub(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+	void mul(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+	void addmul(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+	void submul(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+	void div(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+	void mod(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+	void divMod(BigUnsigned &, BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+
 	// template alias for commonly used statement
 	template <typename T>
 	using EnableIfIntegral = typename std::enable_if<std::is_integral<T>::value, int>::type;
 
+	// template alias for the unsigned version of an integral type (bool doesn't
+	// have one, so it stays bool)
+	template <typename T>
+	using MakeUnsigned = typename std::conditional<std::is_same<T, bool>::value, std::common_type<bool>, std::make_unsigned<T>>::type::type;
+
 	class BigUnsigned
 	{
 		/// Friend classes and functions
 		friend BigIntegerUtil;
+		friend BigUnsignedPool;
 		friend BigInteger;
+		template <size_t, bool, OverflowMode> friend class BigFixed;
 		friend bool operator ==(const BigUnsigned &, const BigUnsigned &);
 		friend bool operator <(const BigUnsigned &, const BigUnsigned &);
+		friend void add(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+		friend void sub(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+		friend void mul(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+		friend void addmul(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+		friend void submul(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+		friend void div(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+		friend void mod(BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
+		friend void divMod(BigUnsigned &, BigUnsigned &, const BigUnsigned &, const BigUnsigned &);
 
 	public:
 		/// Constructor
 		BigUnsigned() = default;
 
 		/// Copy constructor
+#ifdef BIGNUMBER_VALUE_SEMANTICS
+		BigUnsigned(const BigUnsigned &rhs) { operator =(rhs); }
+#else
 		BigUnsigned(const BigUnsigned &) = default;
+#endif
 
 		/// Move constructor
 		BigUnsigned(BigUnsigned &&rhs) :pData(std::move(rhs.pData)) {}
@@ -65,7 +144,7 @@ namespace BigNumber
 		BigUnsigned(const T &rhs) { operator =(rhs); }
 
 		/// Destructor
-		~BigUnsigned() = default;
+		~BigUnsigned();
 
 		/// Conversion operator to bool
 		explicit operator bool() const;
@@ -74,7 +153,7 @@ namespace BigNumber
 		template <typename T, EnableIfIntegral<T> = 0> explicit operator T() const;
 
 		/// Assignment operators
-		BigUnsigned &operator =(const BigUnsigned &) = default;
+		BigUnsigned &operator =(const BigUnsigned &);
 		BigUnsigned &operator =(BigUnsigned &&);
 		BigUnsigned &operator =(const bool &);
 		template <typename T, EnableIfIntegral<T> = 0> BigUnsigned &operator =(const T &);
@@ -102,32 +181,70 @@ namespace BigNumber
 		BigUnsigned operator ++(int);
 		BigUnsigned operator --(int);
 
+		/// Three-way comparison (returns -1, 0 or 1 when this is less than, equal to or
+		/// greater than the value). integral values are compared without converting them
+		int compare(const BigUnsigned &) const;
+		template <typename T, EnableIfIntegral<T> = 0> int compare(const T &) const;
+
+		/// Hash of the value (what std::hash uses)
+		size_t hash() const;
+
+		/// Capacity of the data (number of items of the data type)
+		void reserve(size_t);
+		size_t capacity() const;
+		void shrinkToFit();
+
+		/// Bit operations (bit zero is the least significant bit). these only look
+		/// at or change the items holding the bits instead of shifting copies
+		bool testBit(size_t) const;
+		void setBit(size_t);
+		void clearBit(size_t);
+		void flipBit(size_t);
+		size_t bitLength() const; // number of bits without the leading zeros (zero for zero)
+		size_t popcount() const; // number of set bits
+		size_t countTrailingZeros() const; // zero bits below the lowest set bit (npos for zero)
+		size_t scanBit(size_t, bool) const; // first bit at or after a position with the value (npos if there isn't one)
+
+		/// Returned by the bit operations when there isn't a bit to return
+		static constexpr size_t npos = (size_t)-1;
+
 	private:
+		typedef Kernels::limb dataType; // data type
 
-#ifdef _M_X64
-		typedef unsigned long long dataType; // 64-bit data type
+		typedef std::vector<dataType> colType; // collection type
+		static constexpr size_t dataTypeSize = 8 * sizeof(dataType); // number of bits
+
+#if defined(BIGNUMBER_SINGLE_THREADED) || defined(BIGNUMBER_VALUE_SEMANTICS)
+		typedef BigDataPtr<colType> dataPtr; // pointer type with a count that isn't atomic
+		static dataPtr makeData() { return dataPtr::make(); }
 #else
-		typedef unsigned long dataType; // 32-bit data type
+		typedef std::shared_ptr<colType> dataPtr; // pointer type with an atomic count
+		static dataPtr makeData() { return std::make_shared<colType>(); }
 #endif
 
-		typedef std::deque<dataType> colType; // collection type
-		static const size_t dataTypeSize = 8 * sizeof(dataType); // number of bits
-
-		std::shared_ptr<colType> pData; // pointer to data
+		dataPtr pData; // pointer to data
 
 		/// Helper functions
+		bool isDataUnique() const { return pData.use_count() == 1; }
 		void clearData();
+		void releaseData();
 		void makeDataUnique();
+		void reserveData(size_t);
+		void resetData(size_t);
 		void removeLeadingZeros();
+		bool toSize(size_t &) const;
+		void addBit(size_t);
+		void subtractBit(size_t);
 		void add(const BigUnsigned &);
 		void subtract(const BigUnsigned &);
+		void reverseSubtract(const BigUnsigned &);
 		void multiply(const BigUnsigned &);
 		BigUnsigned divideWithRemainder(const BigUnsigned &);
 		void bitAND(const BigUnsigned &);
 		void bitOR(const BigUnsigned &);
 		void bitXOR(const BigUnsigned &);
-		void bitShiftLeft(BigUnsigned);
-		void bitShiftRight(BigUnsigned);
+		void bitShiftLeft(const BigUnsigned &);
+		void bitShiftRight(const BigUnsigned &);
 	};
 
 	/// Conversion operator to integral
@@ -142,7 +259,7 @@ namespace BigNumber
 			// return type's maximum value and throw an
 			// overflow error if it isn't
 
-			if (*this <= std::numeric_limits<T>::max())
+			if (compare(std::numeric_limits<T>::max()) <= 0)
 			{
 				// this next if statement should always be true but it's here
 				// just in case some idiot decides to change the class data
@@ -154,20 +271,12 @@ namespace BigNumber
 					// the size of the class's data type is smaller than
 					// the return data type so it is possible for there
 					// to be more than one item in the data collection.
+					// put them together starting with the most significant
+					// one (shifting as unsigned so the sign bit can be set)
+					typedef typename std::make_unsigned<T>::type unsignedType;
 
-					auto iter = begin(*pData);
-
-					for (size_t i = 0; i < sizeof(T) / sizeof(dataType); ++i)
-					{
-						// shift the return value to the right
-						retVal >>= dataTypeSize;
-
-						if (iter != end(*pData)) // check if there is more data
-						{
-							memcpy(&retVal, &*iter, sizeof(dataType)); // copy the data to the return value
-							++iter; // increment the iterator
-						}
-					}
+					for (auto iter = std::rbegin(*pData); iter != std::rend(*pData); ++iter)
+						retVal = (T)(((unsignedType)retVal << dataTypeSize) | *iter);
 				}
 			}
 			else
@@ -177,6 +286,47 @@ namespace BigNumber
 		return retVal;
 	}
 
+	/// Three-way comparison with integral type
+	template <typename T, EnableIfIntegral<T>>
+	int BigUnsigned::compare(const T &rhs) const
+	{
+		// every negative number is smaller
+		if (rhs < 0)
+			return 1;
+
+		const size_t size = pData ? pData->size() : 0;
+
+		// this next if statement should always be true. see comments
+		// in the conversion operator as to why it could be false
+		if (sizeof(dataType) >= sizeof(T))
+		{
+			if (size > 1)
+				return 1;
+
+			const dataType item = size == 1 ? pData->front() : 0, value = (dataType)rhs;
+			return item < value ? -1 : (item > value ? 1 : 0);
+		}
+		else
+		{
+			// rhs takes more than one item so compare
+			// them starting with the most significant one
+			const size_t items = sizeof(T) / sizeof(dataType);
+
+			if (size > items)
+				return 1;
+
+			for (size_t i = items; i-- > 0;)
+			{
+				const dataType item = i < size ? (*pData)[i] : 0, value = (dataType)(rhs >> (i * dataTypeSize));
+
+				if (item != value)
+					return item < value ? -1 : 1;
+			}
+
+			return 0;
+		}
+	}
+
 	/// Integral assignment operator
 	template <typename T, EnableIfIntegral<T>>
 	BigUnsigned &BigUnsigned::operator =(const T &rhs)
@@ -224,17 +374,23 @@ namespace BigNumber
 	/// Arithmetic operators
 	inline BigUnsigned operator +(const BigUnsigned &lhs, const BigUnsigned &rhs)
 	{
-		return std::move(BigUnsigned(lhs) += rhs);
+		BigUnsigned retVal;
+		add(retVal, lhs, rhs);
+		return retVal;
 	}
 
 	inline BigUnsigned operator -(const BigUnsigned &lhs, const BigUnsigned &rhs)
 	{
-		return std::move(BigUnsigned(lhs) -= rhs);
+		BigUnsigned retVal;
+		sub(retVal, lhs, rhs);
+		return retVal;
 	}
 
 	inline BigUnsigned operator *(const BigUnsigned &lhs, const BigUnsigned &rhs)
 	{
-		return std::move(BigUnsigned(lhs) *= rhs);
+		BigUnsigned retVal;
+		mul(retVal, lhs, rhs);
+		return retVal;
 	}
 
 	inline BigUnsigned operator /(const BigUnsigned &lhs, const BigUnsigned &rhs)
@@ -343,6 +499,110 @@ namespace BigNumber
 	{
 		return !(lhs < rhs);
 	}
+
+	/// Comparison operators with integral types
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator ==(const BigUnsigned &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) == 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator !=(const BigUnsigned &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) != 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator <(const BigUnsigned &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) < 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator >(const BigUnsigned &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) > 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator <=(const BigUnsigned &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) <= 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator >=(const BigUnsigned &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) >= 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator ==(const T &lhs, const BigUnsigned &rhs)
+	{
+		return rhs.compare(lhs) == 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator !=(const T &lhs, const BigUnsigned &rhs)
+	{
+		return rhs.compare(lhs) != 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator <(const T &lhs, const BigUnsigned &rhs)
+	{
+		return rhs.compare(lhs) > 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator >(const T &lhs, const BigUnsigned &rhs)
+	{
+		return rhs.compare(lhs) < 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator <=(const T &lhs, const BigUnsigned &rhs)
+	{
+		return rhs.compare(lhs) >= 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline bool operator >=(const T &lhs, const BigUnsigned &rhs)
+	{
+		return rhs.compare(lhs) <= 0;
+	}
+
+#ifdef BIGNUMBER_THREE_WAY_COMPARISON
+	/// Three-way comparison operators
+	inline std::strong_ordering operator <=>(const BigUnsigned &lhs, const BigUnsigned &rhs)
+	{
+		return lhs.compare(rhs) <=> 0;
+	}
+
+	template <typename T, EnableIfIntegral<T> = 0>
+	inline std::strong_ordering operator <=>(const BigUnsigned &lhs, const T &rhs)
+	{
+		return lhs.compare(rhs) <=> 0;
+	}
+#endif
 } // namespace BigNumber
 
+namespace std
+{
+	/// Hash for unordered containers
+	template <>
+	struct hash<BigNumber::BigUnsigned>
+	{
+		size_t operator ()(const BigNumber::BigUnsigned &value) const
+		{
+			return value.hash();
+		}
+	};
+} // namespace std
+
+#ifdef BIGUNSIGNED_H_SOURCES
+#include "BigSources.h"
+#endif
+
 #endif // BIGUNSIGNED_H
@@ -0,0 +1,245 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#include "BigUnsignedPool.h"
+#include "BigInstrumentation.h"
+
+namespace BigNumber
+{
+	namespace detail
+	{
+		BIGNUMBER_INLINE const size_t bucketCount = 8 * sizeof(size_t); // one bucket for every power of two
+		BIGNUMBER_INLINE const size_t minimumCapacity = 4; // smallest capacity of a new buffer
+
+		// returns the smallest n where 2^n is bigger than or equal to value
+		BIGNUMBER_INLINE size_t ceilLog2(size_t value)
+		{
+			size_t n = 0;
+
+			while (n < bucketCount - 1 && ((size_t)1 << n) < value)
+				++n;
+
+			return n;
+		}
+
+		// returns the biggest n where 2^n is smaller than or equal to value
+		BIGNUMBER_INLINE size_t floorLog2(size_t value)
+		{
+			size_t n = 0;
+
+			while (value >>= 1)
+				++n;
+
+			return n;
+		}
+	} // namespace detail
+
+	using namespace detail;
+
+	// everything kept by the pool of one thread
+	struct BigUnsignedPool::ThreadData
+	{
+		std::vector<pointer> buckets[bucketCount]; // free buffers by capacity
+		Statistics stats; // counters
+		size_t maxPerBucket = 16; // most buffers kept in a bucket
+		size_t maxSize = (size_t)1 << 16; // biggest buffer kept (number of items)
+	};
+
+	// threadData returns the current thread's pool or nullptr if it was already destroyed
+	BIGNUMBER_INLINE BigUnsignedPool::ThreadData *BigUnsignedPool::threadData()
+	{
+		// the pool of the current thread is created the first time it's used.
+		// a plain pointer is used so BigUnsigned objects destroyed after the
+		// thread's pool (static objects on the main thread) can still check it
+		static thread_local ThreadData *pool = nullptr;
+		static thread_local bool destroyed = false;
+
+		// deletes the thread's pool when the thread exits
+		struct Owner
+		{
+			~Owner()
+			{
+				delete pool;
+				pool = nullptr;
+				destroyed = true;
+			}
+		};
+
+		if (!pool && !destroyed)
+		{
+			static thread_local Owner owner; // registers the cleanup for this thread
+			pool = new ThreadData();
+		}
+
+		return pool;
+	}
+
+	/// Fraction of requests that were served by the pool
+	BIGNUMBER_INLINE double BigUnsignedPool::Statistics::hitRate() const
+	{
+		if (hits + misses == 0)
+			return 0.0;
+
+		return (double)hits / (double)(hits + misses);
+	}
+
+	/// Get the calling thread's counters
+	BIGNUMBER_INLINE BigUnsignedPool::Statistics BigUnsignedPool::statistics()
+	{
+		if (ThreadData *pool = threadData())
+			return pool->stats;
+		else
+			return Statistics();
+	}
+
+	/// Reset the calling thread's counters
+	BIGNUMBER_INLINE void BigUnsignedPool::resetStatistics()
+	{
+		if (ThreadData *pool = threadData())
+			pool->stats = Statistics();
+	}
+
+	/// Free every buffer kept by the calling thread's pool
+	BIGNUMBER_INLINE void BigUnsignedPool::clear()
+	{
+		if (ThreadData *pool = threadData())
+		{
+			for (auto &bucket : pool->buckets)
+				bucket.clear();
+		}
+	}
+
+	/// Set the most buffers kept in each bucket
+	BIGNUMBER_INLINE void BigUnsignedPool::setMaxBuffersPerBucket(size_t value)
+	{
+		if (ThreadData *pool = threadData())
+		{
+			pool->maxPerBucket = value;
+
+			// drop the buffers that don't fit anymore
+			for (auto &bucket : pool->buckets)
+			{
+				if (bucket.size() > value)
+					bucket.resize(value);
+			}
+		}
+	}
+
+	/// Set the biggest buffer (number of items) that is kept
+	BIGNUMBER_INLINE void BigUnsignedPool::setMaxBufferSize(size_t value)
+	{
+		if (ThreadData *pool = threadData())
+		{
+			pool->maxSize = value;
+
+			// drop the buckets that are too big now
+			for (size_t i = 0; i < bucketCount; ++i)
+			{
+				if (((size_t)1 << i) > value)
+					pool->buckets[i].clear();
+			}
+		}
+	}
+
+	/// Get the most buffers kept in each bucket
+	BIGNUMBER_INLINE size_t BigUnsignedPool::maxBuffersPerBucket()
+	{
+		if (ThreadData *pool = threadData())
+			return pool->maxPerBucket;
+		else
+			return 0;
+	}
+
+	/// Get the biggest buffer (number of items) that is kept
+	BIGNUMBER_INLINE size_t BigUnsignedPool::maxBufferSize()
+	{
+		if (ThreadData *pool = threadData())
+			return pool->maxSize;
+		else
+			return 0;
+	}
+
+	// acquire returns an empty buffer that can hold at least size items
+	BIGNUMBER_INLINE BigUnsignedPool::pointer BigUnsignedPool::acquire(size_t size)
+	{
+		ThreadData *pool = threadData();
+
+		if (pool)
+		{
+			// every buffer in bucket n or above is big enough, so use
+			// the smallest one that isn't empty
+			for (size_t i = ceilLog2(size); i < bucketCount; ++i)
+			{
+				auto &bucket = pool->buckets[i];
+
+				if (!bucket.empty())
+				{
+					pointer retVal = std::move(bucket.back());
+					bucket.pop_back();
+					++pool->stats.hits;
+					return retVal;
+				}
+			}
+
+			++pool->stats.misses;
+		}
+
+		// nothing in the pool so make a new buffer. its capacity is rounded
+		// up to a power of two so it goes back to the bucket it came from
+		pointer retVal = BigUnsigned::makeData();
+		retVal->reserve((size_t)1 << ceilLog2(size < minimumCapacity ? minimumCapacity : size));
+		BIGNUMBER_COUNT_ALLOCATION(retVal->capacity() * sizeof(BigUnsigned::dataType));
+		return retVal;
+	}
+
+	// release gives a buffer back to the pool if nothing else is using it
+	BIGNUMBER_INLINE void BigUnsignedPool::release(pointer &data)
+	{
+		ThreadData *pool = threadData();
+
+		if (pool && data.use_count() == 1)
+		{
+			const size_t capacity = data->capacity();
+
+			if (capacity != 0 && capacity <= pool->maxSize)
+			{
+				auto &bucket = pool->buckets[floorLog2(capacity)];
+
+				if (bucket.size() < pool->maxPerBucket)
+				{
+					data->clear(); // the buffer should be empty when it's used again
+					bucket.push_back(std::move(data));
+					++pool->stats.returns;
+					return;
+				}
+			}
+
+			++pool->stats.discards;
+		}
+
+		// it's either shared or there is no room for it
+		data.reset();
+	}
+} // namespace BigNumber
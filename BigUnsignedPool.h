@@ -0,0 +1,91 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+#ifndef BIGUNSIGNEDPOOL_H
+#define BIGUNSIGNEDPOOL_H
+
+// the first header included brings in the sources (see BigConfig.h)
+#if defined(BIGNUMBER_HEADER_ONLY) && !defined(BIGNUMBER_SOURCES)
+#define BIGNUMBER_SOURCES
+#define BIGUNSIGNEDPOOL_H_SOURCES
+#endif
+
+#include "BigUnsigned.h"
+
+namespace BigNumber
+{
+	// BigUnsignedPool keeps a free list of data buffers for every thread so
+	// BigUnsigned can reuse them instead of going to the global allocator.
+	// The buffers are put in buckets by capacity (bucket n holds buffers that
+	// can hold at least 2^n items) and every count is for the calling thread.
+	class BigUnsignedPool
+	{
+		/// Friend classes
+		friend BigUnsigned;
+
+	public:
+		/// Counters for the calling thread's pool
+		struct Statistics
+		{
+			size_t hits = 0; // buffers handed out from the pool
+			size_t misses = 0; // buffers that had to be allocated
+			size_t returns = 0; // buffers given back and kept in the pool
+			size_t discards = 0; // buffers given back but freed because the pool was full
+
+			/// Fraction of requests that were served by the pool
+			double hitRate() const;
+		};
+
+		/// Get and reset the calling thread's counters
+		static Statistics statistics();
+		static void resetStatistics();
+
+		/// Free every buffer kept by the calling thread's pool
+		static void clear();
+
+		/// Limits of the calling thread's pool
+		static void setMaxBuffersPerBucket(size_t);
+		static void setMaxBufferSize(size_t);
+		static size_t maxBuffersPerBucket();
+		static size_t maxBufferSize();
+
+	private:
+		typedef BigUnsigned::colType colType; // collection type
+		typedef BigUnsigned::dataPtr pointer; // pointer to a buffer
+
+		struct ThreadData; // everything kept by the pool of one thread
+
+		/// Helper functions
+		static ThreadData *threadData();
+		static pointer acquire(size_t);
+		static void release(pointer &);
+	};
+} // namespace BigNumber
+
+#ifdef BIGUNSIGNEDPOOL_H_SOURCES
+#include "BigSources.h"
+#endif
+
+#endif // BIGUNSIGNEDPOOL_H
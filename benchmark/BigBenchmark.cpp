@@ -0,0 +1,808 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+// Benchmarks for the BigUnsigned and BigInteger operations. Every benchmark that
+// takes a size gets it in limbs and reports it as the complexity N, so the output
+// shows how each operation grows. --benchmark_format=json (or --benchmark_out with
+// --benchmark_out_format=json) gives results that can be kept and compared between
+// versions with Google Benchmark's compare.py. The kernels, limb size and number
+// of threads are put in the context so results from different builds and machines
+// can be told apart.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BigBatch.h"
+#include "BigExpression.h"
+#include "BigIntegerUtil.h"
+#include "BigThreadPool.h"
+
+using namespace std;
+using namespace BigNumber;
+
+namespace
+{
+	// randomNumber makes a number with exactly the given number of limbs (the
+	// same seed always gives the same number)
+	BigUnsigned randomNumber(size_t limbs, unsigned int seed)
+	{
+		const char digits[] = "0123456789abcdef";
+		mt19937_64 generator(seed);
+		string hex(limbs * Kernels::limbBits / 4, '0');
+
+		for (char &digit : hex)
+			digit = digits[generator() % 16];
+
+		hex.front() = digits[1 + generator() % 15]; // the top digit can't be zero
+
+		return BigIntegerUtil::stringToBigUnsigned(hex, 16);
+	}
+
+	// randomSigned makes a random number with a sign
+	BigInteger randomSigned(size_t limbs, unsigned int seed, bool negative)
+	{
+		BigInteger retVal = BigIntegerUtil::stringToBigInteger(BigIntegerUtil::bigUnsignedToString(randomNumber(limbs, seed), 16), 16);
+		return negative ? -retVal : retVal;
+	}
+
+	// sizes goes from one limb up to 2^15 limbs (two million bits with 64-bit limbs)
+	void sizes(benchmark::internal::Benchmark *benchmark)
+	{
+		benchmark->RangeMultiplier(8)->Range(1, 1 << 15);
+	}
+
+	// finish reports the size and the number of bytes of each operand that were processed
+	void finish(benchmark::State &state)
+	{
+		const int64_t limbs = state.range(0);
+		state.SetComplexityN(limbs);
+		state.SetBytesProcessed((int64_t)state.iterations() * limbs * (int64_t)sizeof(Kernels::limb));
+	}
+
+	/// Arithmetic
+	void unsignedAdd(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1), b = randomNumber(state.range(0), 2);
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			add(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void unsignedSubtract(benchmark::State &state)
+	{
+		BigUnsigned a = randomNumber(state.range(0), 1), b = randomNumber(state.range(0), 2), out;
+
+		if (a < b)
+			swap(a, b);
+
+		for (auto _ : state)
+		{
+			sub(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void unsignedMultiply(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1), b = randomNumber(state.range(0), 2);
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			mul(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void unsignedSquare(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1);
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			mul(out, a, a);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	// the dividend is twice as long as the divisor, which is the worst case
+	void unsignedDivide(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(2 * state.range(0), 1), b = randomNumber(state.range(0), 2);
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			div(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void unsignedModulo(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(2 * state.range(0), 1), b = randomNumber(state.range(0), 2);
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			mod(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	/// Shifts (these copy the value first like x << n does)
+	void unsignedShiftLeft(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1), amount = state.range(0) * Kernels::limbBits / 2 + 7;
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			out = a;
+			out <<= amount;
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void unsignedShiftRight(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1), amount = state.range(0) * Kernels::limbBits / 2 + 7;
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			out = a;
+			out >>= amount;
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	/// Bitwise operations (these work in place so the buffer is never copied)
+	void unsignedAnd(benchmark::State &state)
+	{
+		const BigUnsigned b = randomNumber(state.range(0), 2);
+		BigUnsigned out = randomNumber(state.range(0), 1);
+
+		for (auto _ : state)
+		{
+			out &= b;
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void unsignedOr(benchmark::State &state)
+	{
+		const BigUnsigned b = randomNumber(state.range(0), 2);
+		BigUnsigned out = randomNumber(state.range(0), 1);
+
+		for (auto _ : state)
+		{
+			out |= b;
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void unsignedXor(benchmark::State &state)
+	{
+		const BigUnsigned b = randomNumber(state.range(0), 2);
+		BigUnsigned out = randomNumber(state.range(0), 1);
+
+		for (auto _ : state)
+		{
+			out ^= b;
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void unsignedNot(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1);
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			out = ~a;
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	/// Comparison (the values only differ in the lowest bit so every limb is looked at)
+	void unsignedCompare(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1);
+		BigUnsigned b = a;
+		b.flipBit(0);
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(a.compare(b));
+
+		finish(state);
+	}
+
+	/// Conversion to and from decimal strings
+	void unsignedParse(benchmark::State &state)
+	{
+		const string text = BigIntegerUtil::bigUnsignedToString(randomNumber(state.range(0), 1));
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(BigIntegerUtil::stringToBigUnsigned(text));
+
+		finish(state);
+	}
+
+	void unsignedFormat(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1);
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(BigIntegerUtil::bigUnsignedToString(a));
+
+		finish(state);
+	}
+
+	/// Hashing
+	void unsignedHash(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1);
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(a.hash());
+
+		finish(state);
+	}
+
+	/// Signed operations that need more than the unsigned ones
+	void signedAddMixedSigns(benchmark::State &state)
+	{
+		const BigInteger a = randomSigned(state.range(0), 1, false), b = randomSigned(state.range(0), 2, true);
+		BigInteger out;
+
+		for (auto _ : state)
+		{
+			add(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void signedSubtractMixedSigns(benchmark::State &state)
+	{
+		const BigInteger a = randomSigned(state.range(0), 1, true), b = randomSigned(state.range(0), 2, false);
+		BigInteger out;
+
+		for (auto _ : state)
+		{
+			sub(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void signedMultiply(benchmark::State &state)
+	{
+		const BigInteger a = randomSigned(state.range(0), 1, true), b = randomSigned(state.range(0), 2, false);
+		BigInteger out;
+
+		for (auto _ : state)
+		{
+			mul(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	// both are negative so both go through two's complement
+	void signedAndNegative(benchmark::State &state)
+	{
+		const BigInteger b = randomSigned(state.range(0), 2, true);
+		BigInteger out = randomSigned(state.range(0), 1, true);
+
+		for (auto _ : state)
+		{
+			out &= b;
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void signedCompare(benchmark::State &state)
+	{
+		const BigInteger a = randomSigned(state.range(0), 1, true);
+		BigInteger b = a;
+		b.flipBit(0);
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(a.compare(b));
+
+		finish(state);
+	}
+
+	// comparing with an integral value doesn't make a BigInteger out of it
+	void signedCompareIntegral(benchmark::State &state)
+	{
+		const BigInteger a = -123456789;
+		long long value = -123456788;
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(value);
+			benchmark::DoNotOptimize(a < value);
+		}
+	}
+
+	void signedParse(benchmark::State &state)
+	{
+		const string text = BigIntegerUtil::bigIntegerToString(randomSigned(state.range(0), 1, true));
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(BigIntegerUtil::stringToBigInteger(text));
+
+		finish(state);
+	}
+
+	void signedFormat(benchmark::State &state)
+	{
+		const BigInteger a = randomSigned(state.range(0), 1, true);
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(BigIntegerUtil::bigIntegerToString(a));
+
+		finish(state);
+	}
+
+	// looks up every key of an unordered_map with 2^14 keys of the given size
+	void signedHashMapLookup(benchmark::State &state)
+	{
+		const size_t count = 1 << 14;
+		vector<BigInteger> keys;
+		unordered_map<BigInteger, size_t> map;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			keys.push_back(randomSigned(state.range(0), (unsigned int)i, i % 2 == 0));
+			map[keys.back()] = i;
+		}
+
+		for (auto _ : state)
+		{
+			for (const BigInteger &key : keys)
+				benchmark::DoNotOptimize(map.find(key));
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)count);
+	}
+
+	/// Scaling with the number of threads (the second argument is the thread count). the
+	/// products are well above the parallel threshold so Karatsuba splits them between threads
+	void threadsMultiply(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1), b = randomNumber(state.range(0), 2);
+		const size_t threads = BigThreadPool::threadCount();
+		BigUnsigned out;
+
+		BigThreadPool::setThreadCount((size_t)state.range(1));
+
+		for (auto _ : state)
+		{
+			mul(out, a, b);
+			benchmark::DoNotOptimize(out);
+		}
+
+		BigThreadPool::setThreadCount(threads);
+		finish(state);
+	}
+
+	// threadCounts goes from one to 32 threads for a few big sizes
+	void threadCounts(benchmark::internal::Benchmark *benchmark)
+	{
+		for (int64_t limbs : { 1 << 12, 1 << 15 })
+		{
+			for (int64_t threads = 1; threads <= 32; threads *= 2)
+				benchmark->Args({ limbs, threads });
+		}
+	}
+
+	/// Overhead of the thread pool: running empty tasks (the arguments are the number
+	/// of tasks and the thread count), so the time is what scheduling them costs
+	void poolRun(benchmark::State &state)
+	{
+		const size_t count = (size_t)state.range(0), threads = BigThreadPool::threadCount();
+		const vector<function<void()>> tasks(count, []() {});
+
+		BigThreadPool::setThreadCount((size_t)state.range(1));
+
+		for (auto _ : state)
+			BigThreadPool::run(tasks.data(), count);
+
+		BigThreadPool::setThreadCount(threads);
+		state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)count);
+	}
+
+	/// Batches of 256-bit integers against doing the same with a loop over BigUnsigned
+	/// values (the argument is the number of integers)
+	typedef BigBatch<256> Batch;
+
+	// randomBatch makes a batch of random integers and the same values as BigUnsigned
+	Batch randomBatch(size_t count, unsigned int seed, vector<BigUnsigned> &values)
+	{
+		const size_t limbs = 256 / Kernels::limbBits;
+		Batch retVal(count);
+		values.clear();
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			values.push_back(randomNumber(limbs, seed + (unsigned int)i));
+			retVal.set(i, Batch::valueType(values.back()));
+		}
+
+		return retVal;
+	}
+
+	// powMod works out base ^ exponent % modulus with square and multiply
+	BigUnsigned powMod(const BigUnsigned &base, const BigUnsigned &exponent, const BigUnsigned &modulus)
+	{
+		BigUnsigned retVal = 1, square = base % modulus;
+
+		for (size_t i = 0, bits = exponent.bitLength(); i < bits; ++i)
+		{
+			if (exponent.testBit(i))
+			{
+				mul(retVal, retVal, square);
+				mod(retVal, retVal, modulus);
+			}
+
+			mul(square, square, square);
+			mod(square, square, modulus);
+		}
+
+		return retVal;
+	}
+
+	void batchAdd(benchmark::State &state)
+	{
+		vector<BigUnsigned> values;
+		const Batch a = randomBatch(state.range(0), 1, values), b = randomBatch(state.range(0), 100000, values);
+		Batch out;
+
+		for (auto _ : state)
+		{
+			addBatch(out, a, b);
+			benchmark::DoNotOptimize(out.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+	}
+
+	void batchAddLoop(benchmark::State &state)
+	{
+		vector<BigUnsigned> a, b, out(state.range(0));
+		randomBatch(state.range(0), 1, a);
+		randomBatch(state.range(0), 100000, b);
+
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < out.size(); ++i)
+				add(out[i], a[i], b[i]);
+
+			benchmark::DoNotOptimize(out.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+	}
+
+	void batchMultiply(benchmark::State &state)
+	{
+		vector<BigUnsigned> values;
+		const Batch a = randomBatch(state.range(0), 1, values), b = randomBatch(state.range(0), 100000, values);
+		Batch out;
+
+		for (auto _ : state)
+		{
+			mulBatch(out, a, b);
+			benchmark::DoNotOptimize(out.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+	}
+
+	void batchMultiplyLoop(benchmark::State &state)
+	{
+		vector<BigUnsigned> a, b, out(state.range(0));
+		randomBatch(state.range(0), 1, a);
+		randomBatch(state.range(0), 100000, b);
+
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < out.size(); ++i)
+				mul(out[i], a[i], b[i]);
+
+			benchmark::DoNotOptimize(out.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+	}
+
+	// the modulus is odd and has its top bit set
+	BigUnsigned batchModulus()
+	{
+		BigUnsigned retVal = randomNumber(256 / Kernels::limbBits, 7);
+		retVal.setBit(255);
+		retVal.setBit(0);
+		return retVal;
+	}
+
+	void batchPowMod(benchmark::State &state)
+	{
+		vector<BigUnsigned> values;
+		const Batch base = randomBatch(state.range(0), 1, values), exponent = randomBatch(state.range(0), 100000, values);
+		const Batch::valueType modulus(batchModulus());
+		Batch out;
+
+		for (auto _ : state)
+		{
+			powModBatch(out, base, exponent, modulus);
+			benchmark::DoNotOptimize(out.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+	}
+
+	void batchPowModLoop(benchmark::State &state)
+	{
+		vector<BigUnsigned> base, exponent, out(state.range(0));
+		const BigUnsigned modulus = batchModulus();
+		randomBatch(state.range(0), 1, base);
+		randomBatch(state.range(0), 100000, exponent);
+
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < out.size(); ++i)
+				out[i] = powMod(base[i], exponent[i], modulus);
+
+			benchmark::DoNotOptimize(out.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+	}
+
+	/// Expressions worked out eagerly (a new value for each step) and lazily (see BigExpression.h)
+	void expressionEager(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1), b = randomNumber(state.range(0), 2), c = randomNumber(state.range(0), 3),
+			d = randomNumber(state.range(0), 4), e = randomNumber(state.range(0), 5);
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			out = a * b + c * d - e;
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	void expressionLazy(benchmark::State &state)
+	{
+		const BigUnsigned a = randomNumber(state.range(0), 1), b = randomNumber(state.range(0), 2), c = randomNumber(state.range(0), 3),
+			d = randomNumber(state.range(0), 4), e = randomNumber(state.range(0), 5);
+		BigUnsigned out;
+
+		for (auto _ : state)
+		{
+			assign(out, lazy(a) * b + lazy(c) * d - e);
+			benchmark::DoNotOptimize(out);
+		}
+
+		finish(state);
+	}
+
+	/// Containers of numbers. these mostly copy and destroy values, so they show what the
+	/// sharing costs (compare bigint_benchmark with the _single_threaded and _value_semantics builds)
+	const size_t containerCount = 1024; // numbers in each container
+
+	// randomNumbers makes a container of random numbers of the given size
+	vector<BigUnsigned> randomNumbers(size_t limbs)
+	{
+		vector<BigUnsigned> retVal;
+
+		for (size_t i = 0; i < containerCount; ++i)
+			retVal.push_back(randomNumber(limbs, (unsigned int)i));
+
+		return retVal;
+	}
+
+	// copies the whole container
+	void containerCopy(benchmark::State &state)
+	{
+		const vector<BigUnsigned> numbers = randomNumbers(state.range(0));
+
+		for (auto _ : state)
+		{
+			vector<BigUnsigned> copy = numbers;
+			benchmark::DoNotOptimize(copy.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)containerCount);
+	}
+
+	// copies the container and changes every copy, so shared data has to be copied then
+	void containerCopyAndChange(benchmark::State &state)
+	{
+		const vector<BigUnsigned> numbers = randomNumbers(state.range(0));
+
+		for (auto _ : state)
+		{
+			vector<BigUnsigned> copy = numbers;
+
+			for (BigUnsigned &item : copy)
+				++item;
+
+			benchmark::DoNotOptimize(copy.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)containerCount);
+	}
+
+	// sorts a copy of the container, which mostly moves and swaps values
+	void containerSort(benchmark::State &state)
+	{
+		const vector<BigUnsigned> numbers = randomNumbers(state.range(0));
+
+		for (auto _ : state)
+		{
+			vector<BigUnsigned> copy = numbers;
+			sort(copy.begin(), copy.end());
+			benchmark::DoNotOptimize(copy.data());
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)containerCount);
+	}
+
+	// passes every number to a function by value and keeps the biggest
+	void containerPassByValue(benchmark::State &state)
+	{
+		const vector<BigUnsigned> numbers = randomNumbers(state.range(0));
+		const auto larger = [](BigUnsigned a, BigUnsigned b) { return a < b ? b : a; };
+
+		for (auto _ : state)
+		{
+			BigUnsigned biggest;
+
+			for (const BigUnsigned &item : numbers)
+				biggest = larger(biggest, item);
+
+			benchmark::DoNotOptimize(biggest);
+		}
+
+		state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)containerCount);
+	}
+
+	// how values are shared between copies in this build (see BigUnsigned.h)
+	const char *sharing()
+	{
+#if defined(BIGNUMBER_SINGLE_THREADED)
+		return "single threaded";
+#elif defined(BIGNUMBER_VALUE_SEMANTICS)
+		return "value semantics";
+#else
+		return "shared_ptr";
+#endif
+	}
+}
+
+BENCHMARK(unsignedAdd)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedSubtract)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedMultiply)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedSquare)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedDivide)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedModulo)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedShiftLeft)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedShiftRight)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedAnd)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedOr)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedXor)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedNot)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedCompare)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedParse)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedFormat)->Apply(sizes)->Complexity();
+BENCHMARK(unsignedHash)->Apply(sizes)->Complexity();
+BENCHMARK(signedAddMixedSigns)->Apply(sizes)->Complexity();
+BENCHMARK(signedSubtractMixedSigns)->Apply(sizes)->Complexity();
+BENCHMARK(signedMultiply)->Apply(sizes)->Complexity();
+BENCHMARK(signedAndNegative)->Apply(sizes)->Complexity();
+BENCHMARK(signedCompare)->Apply(sizes)->Complexity();
+BENCHMARK(signedCompareIntegral);
+BENCHMARK(signedParse)->Apply(sizes)->Complexity();
+BENCHMARK(signedFormat)->Apply(sizes)->Complexity();
+BENCHMARK(signedHashMapLookup)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK(threadsMultiply)->Apply(threadCounts)->ArgNames({ "limbs", "threads" })->UseRealTime();
+BENCHMARK(poolRun)->ArgsProduct({ { 2, 8, 64 }, { 1, 2, 4 } })->ArgNames({ "tasks", "threads" })->UseRealTime();
+BENCHMARK(batchAdd)->Arg(4096);
+BENCHMARK(batchAddLoop)->Arg(4096);
+BENCHMARK(batchMultiply)->Arg(4096);
+BENCHMARK(batchMultiplyLoop)->Arg(4096);
+BENCHMARK(batchPowMod)->Arg(256);
+BENCHMARK(batchPowModLoop)->Arg(256);
+BENCHMARK(expressionEager)->Apply(sizes)->Complexity();
+BENCHMARK(expressionLazy)->Apply(sizes)->Complexity();
+BENCHMARK(containerCopy)->RangeMultiplier(8)->Range(1, 512);
+BENCHMARK(containerCopyAndChange)->RangeMultiplier(8)->Range(1, 512);
+BENCHMARK(containerSort)->RangeMultiplier(8)->Range(1, 512);
+BENCHMARK(containerPassByValue)->RangeMultiplier(8)->Range(1, 512);
+
+int main(int argc, char **argv)
+{
+	// describe the build so saved results can be matched up
+	benchmark::AddCustomContext("bignumber_kernels", Kernels::implementation());
+	benchmark::AddCustomContext("bignumber_limb_bits", to_string(Kernels::limbBits));
+	benchmark::AddCustomContext("bignumber_threads", to_string(BigThreadPool::threadCount()));
+	benchmark::AddCustomContext("bignumber_sharing", sharing());
+
+	benchmark::Initialize(&argc, argv);
+
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
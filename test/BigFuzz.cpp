@@ -0,0 +1,1633 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+// Differential tests for BigUnsigned, BigInteger, BigFixed, BigBatch and the
+// products in BigIntegerUtil. Every operation is worked out by the library
+// and by a reference, and the results are compared as hex strings. The
+// reference is GMP when the harness is built with it (BIGNUMBER_TEST_GMP),
+// otherwise __int128 arithmetic for operands that fit in 63 bits. Each
+// operation is also worked out several ways (the operators, the compound
+// assignments, the three-address functions with and without the output being
+// an input, lazy expressions, with the thresholds set so that only schoolbook
+// or only Karatsuba multiplication is used, and split between threads), and
+// all of them have to agree with each other even when there's no reference
+// for the sizes. The batches and products are also worked out one at a time.
+//
+// The operands come in the shapes that tend to break carries and division:
+// all ones, powers of two, sparse bits and limbs that alternate between all
+// ones and zero, at sizes around the thresholds, random ones up to a few
+// hundred words and a few thousand words now and then. BigFixed uses 256
+// bits and wraps around, so its results are the reference's cut down to them.
+//
+// Built with BIGNUMBER_LIBFUZZER the inputs come from libFuzzer. Otherwise
+// the program makes random inputs itself:
+//
+// usage: bigint_fuzz [inputs] [seed]  (a random seed is used without one)
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "BigExpression.h"
+#include "BigBatch.h"
+#include "BigIntegerUtil.h"
+#include "BigThreadPool.h"
+
+#ifdef BIGNUMBER_TEST_GMP
+#include <gmp.h>
+#endif
+
+using namespace std;
+using namespace BigNumber;
+
+namespace
+{
+	/// Operations that are checked
+	enum class Operation { Add, Subtract, Multiply, Square, AddMul, SubMul, Divide, And, Or, Xor, ShiftLeft, ShiftRight, Convert, Compare, Not, CompareIntegral, Bits, Hash, PowMod, Factorial, Binomial, Primorial, ProductOf, SumOf };
+	const size_t operationCount = 24;
+
+	const char *operationNames[operationCount] = { "add", "subtract", "multiply", "square", "addmul", "submul", "divide", "and", "or", "xor", "shift left", "shift right", "convert", "compare", "not", "compare with an integral", "single bits", "hash", "power mod", "factorial", "binomial", "primorial", "product of", "sum of" };
+
+	// operations on BigUnsigned and BigInteger (the ones before Not are also on BigFixed)
+	const size_t numberOperations = (size_t)Operation::PowMod, fixedOperations = (size_t)Operation::CompareIntegral;
+
+	/// Types the operations are checked on
+	enum class Kind { Unsigned, Signed, FixedUnsigned, FixedSigned, Batch, Util };
+
+	const char *kindNames[] = { "BigUnsigned", "BigInteger", "BigFixedUnsigned<256>", "BigFixedSigned<256>", "BigBatch<256>", "BigIntegerUtil" };
+
+	const size_t fixedBits = 256; // size of the BigFixed and BigBatch integers
+
+	/// Ways the library works an operation out
+	enum class Route { Operators, Compound, ThreeAddress, Aliased, Lazy, Schoolbook, Karatsuba, Parallel, Functions, OneAtATime };
+
+	const char *routeNames[] = { "operators", "compound assignment", "three-address", "three-address in place", "lazy expression", "schoolbook", "karatsuba", "in parallel", "library functions", "one at a time" };
+
+	// the routes for each kind
+	const vector<Route> numberRoutes = { Route::Operators, Route::Compound, Route::ThreeAddress, Route::Aliased, Route::Lazy, Route::Schoolbook, Route::Karatsuba, Route::Parallel };
+	const vector<Route> fixedRoutes = { Route::Operators, Route::Compound };
+	const vector<Route> functionRoutes = { Route::Functions, Route::Parallel, Route::OneAtATime };
+
+	// a number as 64-bit words from the least significant up (without leading
+	// zero words) and a sign
+	struct Operand
+	{
+		vector<uint64_t> words;
+		bool negative = false;
+	};
+
+	// one operation taken from an input
+	struct Case
+	{
+		Operation operation;
+		Kind kind;
+		bool isSigned;
+		Operand a, b; // the modulus of a batch is a
+		vector<Operand> list; // the numbers of a product or sum, or the bases and exponents of a batch in turn
+		size_t shift; // amount for the shifts and the single bits, and n for the factorials
+		size_t k; // k for the binomials
+		unsigned int base; // base for the conversions
+	};
+
+	// Input hands out the bytes of an input (zero once they run out)
+	class Input
+	{
+	public:
+		Input(const uint8_t *data, size_t size) :data(data), size(size) {}
+
+		bool empty() const { return size == 0; }
+
+		uint8_t byte()
+		{
+			if (!size)
+				return 0;
+
+			--size;
+			return *data++;
+		}
+
+		uint64_t word()
+		{
+			uint64_t retVal = 0;
+
+			for (unsigned int i = 0; i < 64; i += 8)
+				retVal |= (uint64_t)byte() << i;
+
+			return retVal;
+		}
+
+	private:
+		const uint8_t *data;
+		size_t size;
+	};
+
+	size_t failures = 0; // differences found so far
+
+	// nextRandom steps a splitmix64 generator
+	uint64_t nextRandom(uint64_t &state)
+	{
+		uint64_t retVal = (state += 0x9e3779b97f4a7c15);
+		retVal = (retVal ^ (retVal >> 30)) * 0xbf58476d1ce4e5b9;
+		retVal = (retVal ^ (retVal >> 27)) * 0x94d049bb133111eb;
+		return retVal ^ (retVal >> 31);
+	}
+
+	// operandWords picks the number of words in an operand: a few, around one
+	// of the thresholds, up to a few hundred or now and then a few thousand
+	size_t operandWords(uint8_t size)
+	{
+		const Kernels::Thresholds thresholds = Kernels::thresholds();
+		const size_t wordsPerLimb = 64 / Kernels::limbBits, limbsPerWord = Kernels::limbBits / 64; // one of them is zero
+		size_t limbs;
+
+		switch (size % 4)
+		{
+		case 0:
+			return size / 4 % 3;
+		case 1:
+			return size / 4 % 9;
+		case 2:
+			limbs = size / 4 % 3 == 0 ? thresholds.multiply : size / 4 % 3 == 1 ? 2 * thresholds.multiply : thresholds.conversion;
+			limbs = limbs + size / 12 % 7 > 3 ? limbs + size / 12 % 7 - 3 : 0;
+			return wordsPerLimb ? (limbs + wordsPerLimb - 1) / wordsPerLimb : limbs * limbsPerWord;
+		default:
+			// big enough for the parallel and subquadratic paths with the default thresholds
+			if (size / 4 % 16 == 15)
+				return 512 * (1 + size / 64) + size % 61;
+
+			return size / 4 % 64 * 4 + 1;
+		}
+	}
+
+	// makeOperand makes an operand in one of the shapes
+	Operand makeOperand(Input &input, bool allowNegative)
+	{
+		const uint8_t shape = input.byte();
+		const size_t words = operandWords(input.byte());
+		uint64_t state = input.word();
+		const unsigned int topBits = 1 + (unsigned int)(nextRandom(state) % 64); // bits used in the top word
+		Operand retVal;
+
+		retVal.words.resize(words);
+		retVal.negative = allowNegative && (shape & 8);
+
+		if (!words)
+			return retVal;
+
+		switch (shape % 8)
+		{
+		case 0:
+		case 1: // random
+			for (uint64_t &item : retVal.words)
+				item = nextRandom(state);
+			break;
+		case 2: // all ones
+			for (uint64_t &item : retVal.words)
+				item = ~(uint64_t)0;
+			break;
+		case 3: // a power of two
+			break;
+		case 4: // the top bit and the bottom bit
+			retVal.words.front() |= 1;
+			break;
+		case 5: // a few random bits
+			for (uint64_t count = 1 + nextRandom(state) % 4; count > 0; --count)
+			{
+				const size_t bit = (size_t)(nextRandom(state) % (64 * (words - 1) + topBits));
+				retVal.words[bit / 64] |= (uint64_t)1 << (bit % 64);
+			}
+			break;
+		case 6: // words that alternate between all ones and zero
+			for (size_t i = 0; i < words; i += 2)
+				retVal.words[i] = ~(uint64_t)0;
+			break;
+		default: // random with the top word all ones
+			for (uint64_t &item : retVal.words)
+				item = nextRandom(state);
+			retVal.words.back() = ~(uint64_t)0;
+			break;
+		}
+
+		// cut the top word down to its bits, with the highest one set unless
+		// the bits were picked at random
+		retVal.words.back() &= ~(uint64_t)0 >> (64 - topBits);
+
+		if (shape % 8 != 5)
+			retVal.words.back() |= (uint64_t)1 << (topBits - 1);
+
+		while (!retVal.words.empty() && !retVal.words.back())
+			retVal.words.pop_back();
+
+		if (retVal.words.empty())
+			retVal.negative = false;
+
+		return retVal;
+	}
+
+	// listOperand makes an operand for a list from a generator, since an input
+	// is too short to hold many of them
+	Operand listOperand(uint64_t &state, bool allowNegative)
+	{
+		uint8_t bytes[10]; // what makeOperand reads
+
+		for (uint8_t &item : bytes)
+			item = (uint8_t)nextRandom(state);
+
+		Input input(bytes, sizeof(bytes));
+		return makeOperand(input, allowNegative);
+	}
+
+	// fitFixed cuts an operand down so it fits in a BigFixed
+	void fitFixed(Operand &operand, bool isSigned)
+	{
+		const size_t words = fixedBits / 64;
+
+		if (operand.words.size() >= words)
+		{
+			operand.words.resize(words);
+
+			if (isSigned)
+				operand.words.back() &= ~(uint64_t)0 >> 1;
+		}
+
+		while (!operand.words.empty() && !operand.words.back())
+			operand.words.pop_back();
+
+		if (operand.words.empty())
+			operand.negative = false;
+	}
+
+	// readCase takes the next operation from an input
+	Case readCase(Input &input)
+	{
+		static const Kind kinds[] = { Kind::Unsigned, Kind::Unsigned, Kind::Unsigned, Kind::Signed, Kind::Signed, Kind::Signed, Kind::FixedUnsigned, Kind::FixedSigned, Kind::Batch, Kind::Util };
+		static const Operation batchOperations[] = { Operation::Add, Operation::Multiply, Operation::PowMod };
+		const uint8_t code = input.byte(), kind = input.byte();
+		Case retVal;
+
+		retVal.kind = kinds[kind % 10];
+		retVal.isSigned = retVal.kind == Kind::Signed || retVal.kind == Kind::FixedSigned || (retVal.kind == Kind::Util && kind / 10 % 2 != 0);
+
+		switch (retVal.kind)
+		{
+		case Kind::Unsigned:
+		case Kind::Signed:
+			retVal.operation = (Operation)(code % numberOperations);
+			break;
+		case Kind::FixedUnsigned:
+		case Kind::FixedSigned:
+			retVal.operation = (Operation)(code % fixedOperations);
+			break;
+		case Kind::Batch:
+			retVal.operation = batchOperations[code % 3];
+			break;
+		case Kind::Util:
+			retVal.operation = (Operation)((size_t)Operation::Factorial + code % 5);
+			break;
+		}
+
+		retVal.a = makeOperand(input, retVal.isSigned);
+		retVal.b = makeOperand(input, retVal.isSigned);
+
+		// small shifts half of the time so the __int128 reference can check them
+		const uint8_t low = input.byte(), high = input.byte();
+		retVal.shift = low & 1 ? low >> 1 & 63 : (size_t)(high << 7 | low >> 1);
+		retVal.base = 2 + input.byte() % 35;
+		retVal.k = 0;
+
+		if (retVal.kind == Kind::FixedUnsigned || retVal.kind == Kind::FixedSigned)
+		{
+			fitFixed(retVal.a, retVal.isSigned);
+			fitFixed(retVal.b, retVal.isSigned);
+		}
+		else if (retVal.kind == Kind::Batch)
+		{
+			// enough integers to split between threads. the modulus has to be odd
+			const size_t count = 1 + input.byte() % 16;
+			uint64_t state = input.word();
+
+			for (size_t i = 0; i < 2 * count; ++i)
+			{
+				retVal.list.push_back(listOperand(state, false));
+				fitFixed(retVal.list.back(), false);
+			}
+
+			fitFixed(retVal.a, false);
+
+			if (retVal.a.words.empty())
+				retVal.a.words.push_back(0);
+
+			retVal.a.words.front() |= 1;
+		}
+		else if (retVal.kind == Kind::Util)
+		{
+			const size_t count = input.byte() % 12;
+			uint64_t state = input.word();
+
+			for (size_t i = 0; i < count; ++i)
+				retVal.list.push_back(listOperand(state, retVal.isSigned));
+
+			// k is over n now and then, which gives zero
+			retVal.shift %= 2048;
+			retVal.k = (size_t)((retVal.b.words.empty() ? 0 : retVal.b.words.front()) % (retVal.shift + 2));
+		}
+
+		return retVal;
+	}
+
+	// hexOf writes an operand in hex the way the library does
+	string hexOf(const Operand &operand)
+	{
+		if (operand.words.empty())
+			return "0";
+
+		char buffer[17];
+		snprintf(buffer, sizeof(buffer), "%" PRIx64, operand.words.back());
+		string retVal = operand.negative ? string("-") + buffer : string(buffer);
+
+		for (size_t i = operand.words.size() - 1; i-- > 0;)
+		{
+			snprintf(buffer, sizeof(buffer), "%016" PRIx64, operand.words[i]);
+			retVal += buffer;
+		}
+
+		return retVal;
+	}
+
+	// integralOperand gives the integral that an operation compares with: the
+	// low word of b, which is an int64_t for the signed operations
+	Operand integralOperand(const Case &test)
+	{
+		const uint64_t word = test.b.words.empty() ? 0 : test.b.words.front();
+		Operand retVal;
+
+		retVal.negative = test.isSigned && (int64_t)word < 0;
+		retVal.words.push_back(retVal.negative ? 0 - word : word);
+
+		if (!word)
+			retVal.words.clear();
+
+		return retVal;
+	}
+
+	// toNumber makes the library's value of an operand
+	void toNumber(const Operand &operand, BigUnsigned &value)
+	{
+		value = 0;
+
+		for (size_t i = operand.words.size(); i-- > 0;)
+		{
+			value <<= 64;
+			value |= operand.words[i];
+		}
+	}
+
+	void toNumber(const Operand &operand, BigInteger &value)
+	{
+		BigUnsigned magnitude;
+		toNumber(operand, magnitude);
+		value = BigIntegerUtil::toSigned(magnitude);
+
+		if (operand.negative)
+			value = -value;
+	}
+
+	template <size_t Bits, bool Signed>
+	void toNumber(const Operand &operand, BigFixed<Bits, Signed> &value)
+	{
+		typename conditional<Signed, BigInteger, BigUnsigned>::type number;
+		toNumber(operand, number);
+		value = BigFixed<Bits, Signed>(number);
+	}
+
+	// toText and fromText convert with the library
+	string toText(const BigUnsigned &value, unsigned int base = 16) { return BigIntegerUtil::bigUnsignedToString(value, base); }
+	string toText(const BigInteger &value, unsigned int base = 16) { return BigIntegerUtil::bigIntegerToString(value, base); }
+	void fromText(const string &text, unsigned int base, BigUnsigned &value) { value = BigIntegerUtil::stringToBigUnsigned(text, base); }
+	void fromText(const string &text, unsigned int base, BigInteger &value) { value = BigIntegerUtil::stringToBigInteger(text, base); }
+
+	template <size_t Bits>
+	string toText(const BigFixed<Bits, false> &value, unsigned int base = 16) { return toText(BigUnsigned(value), base); }
+
+	template <size_t Bits>
+	string toText(const BigFixed<Bits, true> &value, unsigned int base = 16) { return toText(BigInteger(value), base); }
+
+	// compareText writes the result of a comparison
+	string compareText(int result) { return result < 0 ? "-1" : result > 0 ? "1" : "0"; }
+
+	// positionText writes a bit position
+	string positionText(size_t position) { return position == BigUnsigned::npos ? "npos" : to_string(position); }
+
+	// hexDigit gives the value of a hex digit
+	unsigned int hexDigit(char c) { return c <= '9' ? (unsigned int)(c - '0') : (unsigned int)(c - 'a' + 10); }
+
+	// negateDigits negates a hex number in two's complement over its digits
+	string negateDigits(string digits)
+	{
+		bool carry = true; // flip every digit and add one
+
+		for (size_t i = digits.size(); i-- > 0;)
+		{
+			const unsigned int digit = 15 - hexDigit(digits[i]) + carry;
+			carry = digit == 16;
+			digits[i] = "0123456789abcdef"[digit % 16];
+		}
+
+		return digits;
+	}
+
+	// wrapText cuts an exact hex result down to the bits of a BigFixed, the way
+	// the BigFixed operations wrap around
+	string wrapText(const string &text, bool isSigned)
+	{
+		const size_t digits = fixedBits / 4;
+		const bool negative = text[0] == '-';
+		string retVal = text.substr(negative ? 1 : 0);
+
+		retVal = retVal.size() > digits ? retVal.substr(retVal.size() - digits) : string(digits - retVal.size(), '0') + retVal;
+
+		if (negative)
+			retVal = negateDigits(retVal);
+
+		// the top bit is the sign of a signed value
+		const bool wrapsNegative = isSigned && hexDigit(retVal[0]) >= 8;
+
+		if (wrapsNegative)
+			retVal = negateDigits(retVal);
+
+		const size_t first = retVal.find_first_not_of('0');
+		retVal = first == string::npos ? "0" : retVal.substr(first);
+		return wrapsNegative ? "-" + retVal : retVal;
+	}
+
+#ifdef BIGNUMBER_TEST_GMP
+	const char *referenceName = "GMP";
+
+	// Reference holds a GMP integer
+	class Reference
+	{
+	public:
+		Reference() { mpz_init(value); }
+		explicit Reference(const Operand &operand) { mpz_init_set_str(value, hexOf(operand).c_str(), 16); }
+		Reference(const Reference &) = delete;
+		Reference &operator =(const Reference &) = delete;
+		~Reference() { mpz_clear(value); }
+
+		string text(int base = 16) const
+		{
+			vector<char> buffer(mpz_sizeinbase(value, base) + 2);
+			mpz_get_str(buffer.data(), base, value);
+			return buffer.data();
+		}
+
+		mpz_t value;
+	};
+
+	// position gives the library's value of a bit position from GMP
+	size_t position(mp_bitcnt_t value)
+	{
+		return value == ~(mp_bitcnt_t)0 ? BigUnsigned::npos : (size_t)value;
+	}
+
+	// expected works an operation out with the reference (it returns false when
+	// the reference can't do it)
+	bool expected(const Case &test, vector<string> &results)
+	{
+		Reference a(test.a), b(test.b), out, remainder;
+
+		if (test.kind == Kind::Batch)
+		{
+			for (size_t i = 0; i + 1 < test.list.size(); i += 2)
+			{
+				Reference x(test.list[i]), y(test.list[i + 1]);
+
+				if (test.operation == Operation::Add)
+					mpz_add(out.value, x.value, y.value);
+				else if (test.operation == Operation::Multiply)
+					mpz_mul(out.value, x.value, y.value);
+				else
+					mpz_powm(out.value, x.value, y.value, a.value);
+
+				results.push_back(out.text());
+			}
+
+			return true;
+		}
+
+		switch (test.operation)
+		{
+		case Operation::Add:
+			mpz_add(out.value, a.value, b.value);
+			break;
+		case Operation::Subtract:
+			mpz_sub(out.value, a.value, b.value);
+			break;
+		case Operation::Multiply:
+			mpz_mul(out.value, a.value, b.value);
+			break;
+		case Operation::Square:
+			mpz_mul(out.value, a.value, a.value);
+			break;
+		case Operation::AddMul:
+			mpz_mul(out.value, a.value, b.value);
+			mpz_add(out.value, a.value, out.value);
+			break;
+		case Operation::SubMul:
+			mpz_mul(out.value, a.value, b.value);
+			mpz_sub(out.value, a.value, out.value);
+			break;
+		case Operation::Divide:
+			if (!mpz_sgn(b.value))
+			{
+				results = { "throws" };
+				return true;
+			}
+
+			mpz_tdiv_qr(out.value, remainder.value, a.value, b.value);
+			results = { out.text(), remainder.text() };
+			return true;
+		case Operation::And:
+			mpz_and(out.value, a.value, b.value);
+			break;
+		case Operation::Or:
+			mpz_ior(out.value, a.value, b.value);
+			break;
+		case Operation::Xor:
+			mpz_xor(out.value, a.value, b.value);
+			break;
+		case Operation::ShiftLeft:
+			mpz_mul_2exp(out.value, a.value, test.shift);
+			break;
+		case Operation::ShiftRight:
+			mpz_fdiv_q_2exp(out.value, a.value, test.shift);
+			break;
+		case Operation::Convert:
+			results = { a.text((int)test.base), a.text() };
+			return true;
+		case Operation::Compare:
+			results = { compareText(mpz_cmp(a.value, b.value)) };
+			return true;
+		case Operation::Not:
+			if (test.kind != Kind::Unsigned)
+				mpz_com(out.value, a.value);
+			else if (mpz_sgn(a.value))
+			{
+				// BigUnsigned flips the bits of the limbs it has
+				const size_t bits = (mpz_sizeinbase(a.value, 2) + Kernels::limbBits - 1) / Kernels::limbBits * Kernels::limbBits;
+				mpz_setbit(out.value, bits);
+				mpz_sub_ui(out.value, out.value, 1);
+				mpz_xor(out.value, out.value, a.value);
+			}
+			break;
+		case Operation::CompareIntegral:
+		{
+			Reference integral(integralOperand(test));
+			results = { compareText(mpz_cmp(a.value, integral.value)), compareText(mpz_cmp(a.value, integral.value)) };
+			return true;
+		}
+		case Operation::Bits:
+		{
+			Reference set, clear, flip, magnitude;
+			mpz_set(set.value, a.value);
+			mpz_setbit(set.value, test.shift);
+			mpz_set(clear.value, a.value);
+			mpz_clrbit(clear.value, test.shift);
+			mpz_set(flip.value, a.value);
+			mpz_combit(flip.value, test.shift);
+
+			// the length and count of a negative value are of the bits that aren't sign bits
+			if (mpz_sgn(a.value) < 0)
+				mpz_com(magnitude.value, a.value);
+			else
+				mpz_set(magnitude.value, a.value);
+
+			results = { to_string(mpz_tstbit(a.value, test.shift)), set.text(), clear.text(), flip.text(),
+				to_string(mpz_sgn(magnitude.value) ? mpz_sizeinbase(magnitude.value, 2) : 0), to_string(mpz_popcount(magnitude.value)),
+				positionText(mpz_sgn(a.value) ? position(mpz_scan1(a.value, 0)) : BigUnsigned::npos),
+				positionText(position(mpz_scan1(a.value, test.shift))), positionText(position(mpz_scan0(a.value, test.shift))) };
+			return true;
+		}
+		case Operation::Hash:
+		case Operation::PowMod:
+			return false;
+		case Operation::Factorial:
+			mpz_fac_ui(out.value, test.shift);
+			break;
+		case Operation::Binomial:
+			mpz_bin_uiui(out.value, test.shift, test.k);
+			break;
+		case Operation::Primorial:
+			mpz_primorial_ui(out.value, test.shift);
+			break;
+		case Operation::ProductOf:
+			mpz_set_ui(out.value, 1);
+
+			for (const Operand &item : test.list)
+			{
+				Reference value(item);
+				mpz_mul(out.value, out.value, value.value);
+			}
+			break;
+		case Operation::SumOf:
+			for (const Operand &item : test.list)
+			{
+				Reference value(item);
+				mpz_add(out.value, out.value, value.value);
+			}
+			break;
+		}
+
+		// BigUnsigned throws instead of going below zero
+		if (test.kind == Kind::Unsigned && mpz_sgn(out.value) < 0)
+			results = { "throws" };
+		else
+			results = { out.text() };
+
+		return true;
+	}
+#elif defined(__SIZEOF_INT128__)
+	const char *referenceName = "__int128";
+
+	typedef __int128 wide; // data type of the reference
+
+	// wideText writes a reference value in a base
+	string wideText(wide value, unsigned int base = 16)
+	{
+		unsigned __int128 magnitude = value < 0 ? 0 - (unsigned __int128)value : (unsigned __int128)value;
+		string retVal;
+
+		do
+		{
+			const unsigned int digit = (unsigned int)(magnitude % base);
+			retVal.insert(retVal.begin(), digit < 10 ? char('0' + digit) : char('a' + digit - 10));
+			magnitude /= base;
+		} while (magnitude);
+
+		return value < 0 ? "-" + retVal : retVal;
+	}
+
+	// toWide gives the reference value of an operand (false when it doesn't fit
+	// in 63 bits, which keeps every result the reference works out in range)
+	bool toWide(const Operand &operand, wide &value)
+	{
+		if (operand.words.size() > 1 || (!operand.words.empty() && operand.words.front() >> 63))
+			return false;
+
+		value = operand.words.empty() ? 0 : (wide)operand.words.front();
+
+		if (operand.negative)
+			value = -value;
+
+		return true;
+	}
+
+	// wideScan finds the first bit at or after a position with a value
+	size_t wideScan(wide value, size_t first, bool bit)
+	{
+		for (size_t i = first; i < 128; ++i)
+		{
+			if ((((value >> i) & 1) != 0) == bit)
+				return i;
+		}
+
+		return BigUnsigned::npos;
+	}
+
+	// expectedBatch works out the integers of a batch that fit
+	bool expectedBatch(const Case &test, vector<string> &results)
+	{
+		wide modulus, x, y, out;
+
+		if (!toWide(test.a, modulus))
+			return false;
+
+		for (size_t i = 0; i + 1 < test.list.size(); i += 2)
+		{
+			if (!toWide(test.list[i], x) || !toWide(test.list[i + 1], y))
+				return false;
+
+			if (test.operation == Operation::Add)
+				out = x + y;
+			else if (test.operation == Operation::Multiply)
+				out = x * y;
+			else
+			{
+				// the products stay under 2^126 with the values under the modulus
+				out = 1 % modulus;
+				x %= modulus;
+
+				for (; y; y >>= 1, x = x * x % modulus)
+				{
+					if (y & 1)
+						out = out * x % modulus;
+				}
+			}
+
+			results.push_back(wideText(out));
+		}
+
+		return true;
+	}
+
+	// expectedUtil works out the products and sums that fit
+	bool expectedUtil(const Case &test, vector<string> &results)
+	{
+		const size_t n = test.shift;
+		wide out = test.operation == Operation::SumOf ? 0 : 1, value;
+
+		switch (test.operation)
+		{
+		case Operation::Factorial:
+			if (n > 33)
+				return false;
+
+			for (size_t i = 2; i <= n; ++i)
+				out *= i;
+			break;
+		case Operation::Binomial:
+			if (n > 60)
+				return false;
+
+			if (test.k > n)
+				out = 0;
+
+			for (size_t i = 0; i < test.k && i < n; ++i)
+				out = out * (n - i) / (i + 1);
+			break;
+		case Operation::Primorial:
+			if (n > 100)
+				return false;
+
+			for (size_t p = 2; p <= n; ++p)
+			{
+				bool prime = true;
+
+				for (size_t d = 2; d * d <= p; ++d)
+					prime = prime && p % d != 0;
+
+				if (prime)
+					out *= p;
+			}
+			break;
+		default:
+			if (test.operation == Operation::ProductOf && test.list.size() > 2)
+				return false;
+
+			for (const Operand &item : test.list)
+			{
+				if (!toWide(item, value))
+					return false;
+
+				out = test.operation == Operation::SumOf ? out + value : out * value;
+			}
+			break;
+		}
+
+		results = { wideText(out) };
+		return true;
+	}
+
+	// expected works an operation out with the reference (it returns false when
+	// the reference can't do it)
+	bool expected(const Case &test, vector<string> &results)
+	{
+		wide a, b, out = 0;
+
+		if (test.kind == Kind::Batch)
+			return expectedBatch(test, results);
+
+		if (test.kind == Kind::Util)
+			return expectedUtil(test, results);
+
+		if (!toWide(test.a, a) || !toWide(test.b, b) || test.shift >= 64)
+			return false;
+
+		switch (test.operation)
+		{
+		case Operation::Add:
+			out = a + b;
+			break;
+		case Operation::Subtract:
+			out = a - b;
+			break;
+		case Operation::Multiply:
+			out = a * b;
+			break;
+		case Operation::Square:
+			out = a * a;
+			break;
+		case Operation::AddMul:
+			out = a + a * b;
+			break;
+		case Operation::SubMul:
+			out = a - a * b;
+			break;
+		case Operation::Divide:
+			if (!b)
+				results = { "throws" };
+			else
+				results = { wideText(a / b), wideText(a % b) };
+			return true;
+		case Operation::And:
+			out = a & b;
+			break;
+		case Operation::Or:
+			out = a | b;
+			break;
+		case Operation::Xor:
+			out = a ^ b;
+			break;
+		case Operation::ShiftLeft:
+			out = a * ((wide)1 << test.shift);
+			break;
+		case Operation::ShiftRight:
+			out = a >> test.shift; // an arithmetic shift, which rounds toward negative infinity
+			break;
+		case Operation::Convert:
+			results = { wideText(a, test.base), wideText(a) };
+			return true;
+		case Operation::Compare:
+			results = { compareText(a < b ? -1 : a > b) };
+			return true;
+		case Operation::Not:
+			if (test.kind != Kind::Unsigned)
+				out = ~a;
+			else if (a)
+			{
+				// BigUnsigned flips the bits of the limbs it has
+				size_t bits = Kernels::limbBits;
+
+				while (a >> bits)
+					bits += Kernels::limbBits;
+
+				out = (((wide)1 << bits) - 1) ^ a;
+			}
+			break;
+		case Operation::CompareIntegral:
+		{
+			wide integral;
+
+			if (!toWide(integralOperand(test), integral))
+				return false;
+
+			results = { compareText(a < integral ? -1 : a > integral), compareText(a < integral ? -1 : a > integral) };
+			return true;
+		}
+		case Operation::Bits:
+		{
+			const wide bit = (wide)1 << test.shift;
+			wide magnitude = a < 0 ? ~a : a; // the length and count of a negative value are of the bits that aren't sign bits
+			size_t length = 0, count = 0;
+
+			for (; magnitude; magnitude >>= 1, ++length)
+				count += (size_t)(magnitude & 1);
+
+			results = { to_string((int)((a >> test.shift) & 1)), wideText(a | bit), wideText(a & ~bit), wideText(a ^ bit), to_string(length), to_string(count),
+				positionText(a ? wideScan(a, 0, true) : BigUnsigned::npos), positionText(wideScan(a, test.shift, true)), positionText(wideScan(a, test.shift, false)) };
+			return true;
+		}
+		default:
+			return false;
+		}
+
+		// BigUnsigned throws instead of going below zero
+		if (test.kind == Kind::Unsigned && out < 0)
+			results = { "throws" };
+		else
+			results = { wideText(out) };
+
+		return true;
+	}
+#else
+	const char *referenceName = "none";
+
+	// without a reference only the routes are compared with each other
+	bool expected(const Case &, vector<string> &)
+	{
+		return false;
+	}
+#endif
+
+	// known works out what an operation has to give, and returns where that
+	// came from (nullptr when nothing can say)
+	const char *known(const Case &test, vector<string> &results)
+	{
+		// a hash can only be compared with the hashes of the same value
+		if (test.operation == Operation::Hash)
+		{
+			results = { "same" };
+			return "equal values";
+		}
+
+		if (!expected(test, results))
+			return nullptr;
+
+		// BigFixed and the batch arithmetic wrap around
+		const bool wraps = ((test.kind == Kind::FixedUnsigned || test.kind == Kind::FixedSigned) && test.operation != Operation::Convert && test.operation != Operation::Compare)
+			|| (test.kind == Kind::Batch && test.operation != Operation::PowMod);
+
+		for (string &item : results)
+		{
+			if (wraps && item != "throws")
+				item = wrapText(item, test.isSigned);
+		}
+
+		return referenceName;
+	}
+
+	// ThresholdScope changes the thresholds until it's destroyed
+	class ThresholdScope
+	{
+	public:
+		explicit ThresholdScope(const Kernels::Thresholds &values) :saved(Kernels::thresholds()) { Kernels::setThresholds(values); }
+		ThresholdScope(const ThresholdScope &) = delete;
+		ThresholdScope &operator =(const ThresholdScope &) = delete;
+		~ThresholdScope() { Kernels::setThresholds(saved); }
+
+	private:
+		Kernels::Thresholds saved;
+	};
+
+	// ParallelScope splits everything over a few limbs between threads until
+	// it's destroyed
+	class ParallelScope
+	{
+	public:
+		ParallelScope() :threads(BigThreadPool::threadCount()), threshold(BigThreadPool::parallelThreshold())
+		{
+			BigThreadPool::setThreadCount(4);
+			BigThreadPool::setParallelThreshold(2);
+		}
+
+		ParallelScope(const ParallelScope &) = delete;
+		ParallelScope &operator =(const ParallelScope &) = delete;
+
+		~ParallelScope()
+		{
+			BigThreadPool::setThreadCount(threads);
+			BigThreadPool::setParallelThreshold(threshold);
+		}
+
+	private:
+		size_t threads, threshold;
+	};
+
+	// operators works an operation out with the binary operators
+	template <typename T>
+	vector<string> operators(const Case &test, const T &a, const T &b)
+	{
+		typedef typename conditional<is_same<T, BigInteger>::value, int64_t, uint64_t>::type integralType;
+		T copy;
+
+		switch (test.operation)
+		{
+		case Operation::Add:
+			return { toText(a + b) };
+		case Operation::Subtract:
+			return { toText(a - b) };
+		case Operation::Multiply:
+			return { toText(a * b) };
+		case Operation::Square:
+			return { toText(a * a) };
+		case Operation::AddMul:
+			return { toText(a + a * b) };
+		case Operation::SubMul:
+			return { toText(a - a * b) };
+		case Operation::Divide:
+			return { toText(a / b), toText(a % b) };
+		case Operation::And:
+			return { toText(a & b) };
+		case Operation::Or:
+			return { toText(a | b) };
+		case Operation::Xor:
+			return { toText(a ^ b) };
+		case Operation::ShiftLeft:
+			return { toText(a << T(test.shift)) };
+		case Operation::ShiftRight:
+			return { toText(a >> T(test.shift)) };
+		case Operation::Convert:
+			fromText(toText(a, test.base), test.base, copy);
+			return { toText(a, test.base), toText(copy) };
+		case Operation::Compare:
+			return { compareText(a.compare(b)) };
+		case Operation::Not:
+			return { toText(~a) };
+		case Operation::CompareIntegral:
+		{
+			const integralType value = (integralType)(test.b.words.empty() ? 0 : test.b.words.front());
+			return { compareText(a.compare(value)), compareText(a < value ? -1 : a == value ? 0 : 1) };
+		}
+		case Operation::Bits:
+		{
+			T set = a, clear = a, flip = a;
+			set.setBit(test.shift);
+			clear.clearBit(test.shift);
+			flip.flipBit(test.shift);
+			return { to_string(a.testBit(test.shift)), toText(set), toText(clear), toText(flip), to_string(a.bitLength()), to_string(a.popcount()),
+				positionText(a.countTrailingZeros()), positionText(a.scanBit(test.shift, true)), positionText(a.scanBit(test.shift, false)) };
+		}
+		case Operation::Hash:
+		{
+			// the same value made another way, and with more limbs than it needs
+			const T shifted = (a << T(128)) >> T(128);
+			fromText(toText(a, 7), 7, copy);
+			return { a.hash() == hash<T>()(a) && a.hash() == copy.hash() && a.hash() == shifted.hash() ? "same" : "differs" };
+		}
+		default:
+			break;
+		}
+
+		return {};
+	}
+
+	template <size_t Bits, bool Signed>
+	vector<string> operators(const Case &test, const BigFixed<Bits, Signed> &a, const BigFixed<Bits, Signed> &b)
+	{
+		typedef BigFixed<Bits, Signed> fixedType;
+
+		switch (test.operation)
+		{
+		case Operation::Add:
+			return { toText(a + b) };
+		case Operation::Subtract:
+			return { toText(a - b) };
+		case Operation::Multiply:
+			return { toText(a * b) };
+		case Operation::Square:
+			return { toText(a * a) };
+		case Operation::AddMul:
+			return { toText(a + a * b) };
+		case Operation::SubMul:
+			return { toText(a - a * b) };
+		case Operation::Divide:
+			return { toText(a / b), toText(a % b) };
+		case Operation::And:
+			return { toText(a & b) };
+		case Operation::Or:
+			return { toText(a | b) };
+		case Operation::Xor:
+			return { toText(a ^ b) };
+		case Operation::ShiftLeft:
+			return { toText(a << test.shift) };
+		case Operation::ShiftRight:
+			return { toText(a >> test.shift) };
+		case Operation::Convert:
+			return { toText(a, test.base), toText(fixedType::fromString(toText(a, test.base).c_str(), test.base)) };
+		case Operation::Compare:
+			return { compareText(fixedType::compare(a, b)) };
+		case Operation::Not:
+			return { toText(~a) };
+		default:
+			break;
+		}
+
+		return {};
+	}
+
+	// compound works an operation out with the compound assignment operators
+	template <typename T>
+	vector<string> compound(const Case &test, const T &a, const T &b)
+	{
+		T out = a, other = a;
+
+		switch (test.operation)
+		{
+		case Operation::Add:
+			out += b;
+			break;
+		case Operation::Subtract:
+			out -= b;
+			break;
+		case Operation::Multiply:
+			out *= b;
+			break;
+		case Operation::Square:
+			out *= out;
+			break;
+		case Operation::AddMul:
+			other *= b;
+			out += other;
+			break;
+		case Operation::SubMul:
+			other *= b;
+			out -= other;
+			break;
+		case Operation::Divide:
+			out /= b;
+			other %= b;
+			return { toText(out), toText(other) };
+		case Operation::And:
+			out &= b;
+			break;
+		case Operation::Or:
+			out |= b;
+			break;
+		case Operation::Xor:
+			out ^= b;
+			break;
+		case Operation::ShiftLeft:
+			out <<= test.shift;
+			break;
+		case Operation::ShiftRight:
+			out >>= test.shift;
+			break;
+		case Operation::Compare:
+			return { compareText(a < b ? -1 : a == b ? 0 : 1) };
+		default: // the rest don't have an assignment
+			return operators(test, a, b);
+		}
+
+		return { toText(out) };
+	}
+
+	// threeAddress works an operation out with the three-address functions. when
+	// aliased is set the output is also one of the inputs
+	template <typename T>
+	vector<string> threeAddress(const Case &test, const T &a, const T &b, bool aliased)
+	{
+		T out = aliased ? a : T(), other = aliased ? b : T();
+
+		switch (test.operation)
+		{
+		case Operation::Add:
+			add(out, aliased ? out : a, b);
+			break;
+		case Operation::Subtract:
+			sub(out, aliased ? out : a, b);
+			break;
+		case Operation::Multiply:
+			mul(out, aliased ? out : a, b);
+			break;
+		case Operation::Square:
+			if (aliased)
+				mul(out, out, out);
+			else
+				mul(out, a, a);
+			break;
+		case Operation::AddMul:
+			out = a;
+			addmul(out, aliased ? out : a, b);
+			break;
+		case Operation::SubMul:
+			out = a;
+			submul(out, aliased ? out : a, b);
+			break;
+		case Operation::Divide:
+			if (aliased)
+			{
+				// the quotient replaces the dividend and the remainder the divisor
+				T remainder = b;
+				div(out, out, b);
+				mod(remainder, a, remainder);
+				return { toText(out), toText(remainder) };
+			}
+
+			divMod(out, other, a, b);
+			return { toText(out), toText(other) };
+		default:
+			return compound(test, a, b);
+		}
+
+		return { toText(out) };
+	}
+
+	// lazily works an operation out with an expression that uses its output
+	template <typename T>
+	vector<string> lazily(const Case &test, const T &a, const T &b)
+	{
+		T out = a;
+
+		switch (test.operation)
+		{
+		case Operation::Add:
+			assign(out, lazy(out) + b);
+			break;
+		case Operation::Subtract:
+			assign(out, lazy(out) - b);
+			break;
+		case Operation::Multiply:
+			assign(out, lazy(out) * b);
+			break;
+		case Operation::Square:
+			assign(out, lazy(out) * out);
+			break;
+		case Operation::AddMul:
+			assign(out, lazy(out) + lazy(out) * b);
+			break;
+		case Operation::SubMul:
+			assign(out, lazy(out) - lazy(out) * b);
+			break;
+		default:
+			return operators(test, a, b);
+		}
+
+		return { toText(out) };
+	}
+
+	// run works an operation out one way ("throws" when the library throws)
+	template <typename T>
+	vector<string> run(Route route, const Case &test, const T &a, const T &b)
+	{
+		try
+		{
+			switch (route)
+			{
+			case Route::Compound:
+				return compound(test, a, b);
+			case Route::ThreeAddress:
+				return threeAddress(test, a, b, false);
+			case Route::Aliased:
+				return threeAddress(test, a, b, true);
+			case Route::Lazy:
+				return lazily(test, a, b);
+			case Route::Schoolbook:
+			{
+				const size_t never = (size_t)1 << 30;
+				const ThresholdScope scope({ never, never, never });
+				return operators(test, a, b);
+			}
+			case Route::Karatsuba:
+			{
+				const ThresholdScope scope({ 2, 2, 1 });
+				return operators(test, a, b);
+			}
+			case Route::Parallel:
+			{
+				const ParallelScope scope;
+				return operators(test, a, b);
+			}
+			default:
+				return operators(test, a, b);
+			}
+		}
+		catch (const exception &)
+		{
+			return { "throws" };
+		}
+	}
+
+	template <size_t Bits, bool Signed>
+	vector<string> run(Route route, const Case &test, const BigFixed<Bits, Signed> &a, const BigFixed<Bits, Signed> &b)
+	{
+		try
+		{
+			return route == Route::Compound ? compound(test, a, b) : operators(test, a, b);
+		}
+		catch (const exception &)
+		{
+			return { "throws" };
+		}
+	}
+
+	// powMod works out a power with a square and a multiply for every bit of the exponent
+	BigUnsigned powMod(const BigUnsigned &base, const BigUnsigned &exponent, const BigUnsigned &modulus)
+	{
+		BigUnsigned retVal = BigUnsigned(1) % modulus;
+
+		for (size_t i = exponent.bitLength(); i-- > 0;)
+		{
+			retVal = retVal * retVal % modulus;
+
+			if (exponent.testBit(i))
+				retVal = retVal * base % modulus;
+		}
+
+		return retVal;
+	}
+
+	// batch works an operation out on every integer of a batch, or on them one
+	// at a time with BigFixed and BigUnsigned
+	vector<string> batch(const Case &test, bool oneAtATime)
+	{
+		typedef BigBatch<fixedBits> batchType;
+		typedef batchType::valueType valueType;
+		const size_t count = test.list.size() / 2;
+		batchType x(count), y(count), out(count);
+		valueType modulus, value;
+		vector<string> retVal;
+
+		toNumber(test.a, modulus);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			toNumber(test.list[2 * i], value);
+			x.set(i, value);
+			toNumber(test.list[2 * i + 1], value);
+			y.set(i, value);
+		}
+
+		if (oneAtATime)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (test.operation == Operation::Add)
+					retVal.push_back(toText(x.get(i) + y.get(i)));
+				else if (test.operation == Operation::Multiply)
+					retVal.push_back(toText(x.get(i) * y.get(i)));
+				else
+					retVal.push_back(toText(powMod(BigUnsigned(x.get(i)), BigUnsigned(y.get(i)), BigUnsigned(modulus))));
+			}
+
+			return retVal;
+		}
+
+		if (test.operation == Operation::Add)
+			addBatch(out, x, y);
+		else if (test.operation == Operation::Multiply)
+			mulBatch(out, x, y);
+		else
+			powModBatch(out, x, y, modulus);
+
+		for (size_t i = 0; i < count; ++i)
+			retVal.push_back(toText(out.get(i)));
+
+		return retVal;
+	}
+
+	// functions works out a product or sum with BigIntegerUtil. the lists go
+	// through the vector functions, and the iterator ones when ranges is set
+	template <typename T>
+	vector<string> functions(const Case &test, const vector<T> &list, bool ranges)
+	{
+		switch (test.operation)
+		{
+		case Operation::Factorial:
+			return { toText(BigIntegerUtil::factorial(test.shift)) };
+		case Operation::Binomial:
+			return { toText(BigIntegerUtil::binomial(test.shift, test.k)) };
+		case Operation::Primorial:
+			return { toText(BigIntegerUtil::primorial(test.shift)) };
+		case Operation::ProductOf:
+			return { toText(ranges ? BigIntegerUtil::productOf(list.begin(), list.end()) : BigIntegerUtil::productOf(list)) };
+		case Operation::SumOf:
+			return { toText(ranges ? BigIntegerUtil::sumOf(list.begin(), list.end()) : BigIntegerUtil::sumOf(list)) };
+		default:
+			break;
+		}
+
+		return {};
+	}
+
+	// oneByOne works out a product or sum a number at a time
+	template <typename T>
+	vector<string> oneByOne(const Case &test, const vector<T> &list)
+	{
+		const size_t n = test.shift;
+		BigUnsigned out = 1;
+		T total = test.operation == Operation::SumOf ? 0 : 1;
+		vector<bool> composite(n + 1);
+
+		switch (test.operation)
+		{
+		case Operation::Factorial:
+			for (size_t i = 2; i <= n; ++i)
+				out *= i;
+			break;
+		case Operation::Binomial:
+			if (test.k > n)
+				out = 0;
+
+			// every step is a binomial itself, so the division is exact
+			for (size_t i = 0; i < test.k && i < n; ++i)
+			{
+				out *= n - i;
+				out /= i + 1;
+			}
+			break;
+		case Operation::Primorial:
+			for (size_t p = 2; p <= n; ++p)
+			{
+				if (composite[p])
+					continue;
+
+				out *= p;
+
+				for (size_t i = p * p; i <= n; i += p)
+					composite[i] = true;
+			}
+			break;
+		default:
+			for (const T &item : list)
+			{
+				if (test.operation == Operation::SumOf)
+					total += item;
+				else
+					total *= item;
+			}
+
+			return { toText(total) };
+		}
+
+		return { toText(out) };
+	}
+
+	// join writes results for a report
+	string join(const vector<string> &results)
+	{
+		string retVal;
+
+		for (const string &item : results)
+			retVal += (retVal.empty() ? "" : ", ") + item;
+
+		return retVal;
+	}
+
+	// report prints a difference
+	void report(const Case &test, const char *what, const vector<string> &wanted, const char *source, const vector<string> &got)
+	{
+		++failures;
+		cerr << operationNames[(size_t)test.operation] << " (" << kindNames[(size_t)test.kind] << "): " << what << "\n"
+			<< "  a = " << hexOf(test.a) << "\n"
+			<< "  b = " << hexOf(test.b) << "\n";
+
+		for (size_t i = 0; i < test.list.size(); ++i)
+			cerr << "  list[" << i << "] = " << hexOf(test.list[i]) << "\n";
+
+		cerr << "  shift = " << test.shift << ", k = " << test.k << ", base = " << test.base << "\n"
+			<< "  " << source << ": " << join(wanted) << "\n"
+			<< "  got: " << join(got) << "\n";
+	}
+
+	// compareRoutes works an operation out every way and compares the results
+	// with the reference, or with the first way when there isn't one
+	void compareRoutes(const Case &test, const vector<Route> &routes, const function<vector<string>(Route)> &work)
+	{
+		vector<string> wanted;
+		const char *source = known(test, wanted);
+
+		for (size_t i = 0; i < routes.size(); ++i)
+		{
+			const vector<string> got = work(routes[i]);
+
+			if (!source && i == 0)
+				wanted = got;
+			else if (got != wanted)
+				report(test, routeNames[(size_t)routes[i]], wanted, source ? source : routeNames[(size_t)routes[0]], got);
+		}
+	}
+
+	// check works an operation out on numbers every way
+	template <typename T>
+	void check(const Case &test, const vector<Route> &routes)
+	{
+		T a, b;
+		toNumber(test.a, a);
+		toNumber(test.b, b);
+
+		compareRoutes(test, routes, [&](Route route) { return run(route, test, a, b); });
+
+		// none of that can change the inputs, which share their data with the copies made
+		if (toText(a) != hexOf(test.a) || toText(b) != hexOf(test.b))
+			report(test, "an input was changed", { hexOf(test.a), hexOf(test.b) }, "inputs", { toText(a), toText(b) });
+	}
+
+	// checkBatch works a batch out every way
+	void checkBatch(const Case &test)
+	{
+		compareRoutes(test, functionRoutes, [&](Route route) -> vector<string>
+		{
+			try
+			{
+				if (route != Route::Parallel)
+					return batch(test, route == Route::OneAtATime);
+
+				const ParallelScope scope;
+				return batch(test, false);
+			}
+			catch (const exception &)
+			{
+				return { "throws" };
+			}
+		});
+	}
+
+	// checkUtil works a product or sum out every way
+	template <typename T>
+	void checkUtil(const Case &test)
+	{
+		vector<T> list(test.list.size());
+
+		for (size_t i = 0; i < list.size(); ++i)
+			toNumber(test.list[i], list[i]);
+
+		compareRoutes(test, functionRoutes, [&](Route route) -> vector<string>
+		{
+			try
+			{
+				if (route == Route::OneAtATime)
+					return oneByOne(test, list);
+
+				if (route == Route::Functions)
+					return functions(test, list, false);
+
+				const ParallelScope scope;
+				return functions(test, list, true);
+			}
+			catch (const exception &)
+			{
+				return { "throws" };
+			}
+		});
+	}
+
+	// checkInput checks every operation in an input
+	void checkInput(const uint8_t *data, size_t size)
+	{
+		Input input(data, size);
+
+		while (!input.empty())
+		{
+			const Case test = readCase(input);
+
+			switch (test.kind)
+			{
+			case Kind::Unsigned:
+				check<BigUnsigned>(test, numberRoutes);
+				break;
+			case Kind::Signed:
+				check<BigInteger>(test, numberRoutes);
+				break;
+			case Kind::FixedUnsigned:
+				check<BigFixedUnsigned<fixedBits>>(test, fixedRoutes);
+				break;
+			case Kind::FixedSigned:
+				check<BigFixedSigned<fixedBits>>(test, fixedRoutes);
+				break;
+			case Kind::Batch:
+				checkBatch(test);
+				break;
+			case Kind::Util:
+				if (test.isSigned)
+					checkUtil<BigInteger>(test);
+				else
+					checkUtil<BigUnsigned>(test);
+				break;
+			}
+		}
+	}
+} // namespace
+
+#ifdef BIGNUMBER_LIBFUZZER
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	checkInput(data, size);
+
+	if (failures)
+		abort(); // let libFuzzer save the input
+
+	return 0;
+}
+#else
+int main(int argc, char *argv[])
+{
+	const size_t inputs = argc > 1 ? stoul(argv[1]) : 1000;
+	const uint64_t seed = argc > 2 ? stoull(argv[2]) : random_device()();
+	const size_t inputSize = 96; // enough for a few operations
+
+	for (size_t i = 0; i < inputs; ++i)
+	{
+		// every input has its own seed so a failing one can be run on its own
+		mt19937_64 generator(seed + i);
+		vector<uint8_t> data(inputSize);
+
+		for (uint8_t &item : data)
+			item = (uint8_t)generator();
+
+		const size_t before = failures;
+		checkInput(data.data(), data.size());
+
+		if (failures != before)
+			cerr << "rerun with: bigint_fuzz 1 " << seed + i << "\n\n";
+	}
+
+	cout << inputs << " inputs from seed " << seed << " checked against " << referenceName << ": " << failures << " differences\n";
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,213 @@
+/*
+
+C++ Big Integer Library
+Copyright (C) 2014 Weston Witt
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+USA
+
+
+Email address: weston925@gmail.com
+
+*/
+
+// Measures where the algorithms should change over (see Kernels::Thresholds) on
+// this machine and writes a header with the thresholds. Building the library with
+// BIGNUMBER_TUNING_HEADER set to the header's path makes them the defaults, or a
+// program can include the header after the library's and pass the values to
+// Kernels::setThresholds when it starts. Division only has the schoolbook
+// algorithm (converting to a string divides and conquers under the conversion
+// threshold), so there's nothing to measure for it. Run it on an idle machine.
+//
+// usage: bigint_tune [header]  (the header goes to the standard output without one)
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "BigIntegerUtil.h"
+#include "BigThreadPool.h"
+
+using namespace std;
+using namespace BigNumber;
+
+namespace
+{
+	typedef Kernels::limb limb; // data type
+
+	// randomLimbs makes an array of random limbs with a top limb that isn't zero
+	vector<limb> randomLimbs(size_t size, unsigned int seed)
+	{
+		mt19937_64 generator(seed);
+		vector<limb> retVal(size);
+
+		for (limb &item : retVal)
+			item = (limb)generator();
+
+		retVal.back() |= (limb)1 << (Kernels::limbBits - 1);
+		return retVal;
+	}
+
+	// timePerCall returns the seconds one call takes. each run doubles the calls
+	// until they take long enough to time, and the best run is kept so the cpu
+	// going to another program for a moment doesn't count
+	template <typename Function>
+	double timePerCall(Function function)
+	{
+		const double minimum = 0.002; // seconds a run has to take
+		double best = numeric_limits<double>::max();
+
+		for (int run = 0; run < 5; ++run)
+		{
+			for (size_t calls = 1;; calls *= 2)
+			{
+				const auto start = chrono::steady_clock::now();
+
+				for (size_t i = 0; i < calls; ++i)
+					function();
+
+				const double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+				if (elapsed >= minimum)
+				{
+					best = min(best, elapsed / calls);
+					break;
+				}
+			}
+		}
+
+		return best;
+	}
+
+	// setThreshold changes one of the thresholds
+	void setThreshold(size_t Kernels::Thresholds::*threshold, size_t value)
+	{
+		Kernels::Thresholds values = Kernels::thresholds();
+		values.*threshold = value;
+		Kernels::setThresholds(values);
+	}
+
+	// crossover finds the smallest size where splitting the operation (the
+	// threshold at the size) beats not splitting it (the threshold one above)
+	// there and at the next two sizes tried. time gives the seconds per call
+	// for a size
+	template <typename Time>
+	size_t crossover(const char *name, size_t Kernels::Thresholds::*threshold, size_t first, size_t last, Time time)
+	{
+		size_t wins = 0, found = 0;
+
+		for (size_t size = first; size <= last; size += max<size_t>(1, size / 16))
+		{
+			setThreshold(threshold, size + 1);
+			const double whole = time(size);
+			setThreshold(threshold, size);
+			const double split = time(size);
+
+			cerr << name << ' ' << size << " limbs: " << whole * 1e6 << "us whole, " << split * 1e6 << "us split\n";
+
+			if (split < whole)
+			{
+				if (wins++ == 0)
+					found = size;
+
+				if (wins == 3)
+					return found;
+			}
+			else
+				wins = 0;
+		}
+
+		cerr << name << ": splitting didn't win by " << last << " limbs\n";
+		return last;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	// an option (like --help) isn't a header to write
+	if (argc > 2 || (argc == 2 && argv[1][0] == '-'))
+	{
+		cerr << "usage: " << argv[0] << " [header]  (the header goes to the standard output without one)\n";
+		return argc == 2 && (string(argv[1]) == "--help" || string(argv[1]) == "-h") ? 0 : 1;
+	}
+
+	// one thread so only the algorithms are measured
+	BigThreadPool::setThreadCount(1);
+
+	const Kernels::Thresholds defaults = Kernels::thresholds();
+	Kernels::Thresholds tuned = defaults;
+
+	tuned.multiply = crossover("multiply", &Kernels::Thresholds::multiply, 4, 256, [](size_t size)
+	{
+		const vector<limb> a = randomLimbs(size, 1), b = randomLimbs(size, 2);
+		vector<limb> r(2 * size);
+		return timePerCall([&]() { Kernels::mul(r.data(), a.data(), size, b.data(), size); });
+	});
+
+	tuned.square = crossover("square", &Kernels::Thresholds::square, 4, 256, [](size_t size)
+	{
+		const vector<limb> a = randomLimbs(size, 3);
+		vector<limb> r(2 * size);
+		return timePerCall([&]() { Kernels::mul(r.data(), a.data(), size, a.data(), size); });
+	});
+
+	// a conversion both ways, since writing and reading a number split at the same size
+	tuned.conversion = crossover("conversion", &Kernels::Thresholds::conversion, 4, 512, [](size_t size)
+	{
+		const vector<limb> limbs = randomLimbs(size, 4);
+		BigUnsigned value;
+
+		for (size_t i = size; i-- > 0;)
+			value = (value << Kernels::limbBits) + limbs[i];
+
+		return timePerCall([&]()
+		{
+			const string text = BigIntegerUtil::bigUnsignedToString(value, 10);
+
+			if (BigIntegerUtil::stringToBigUnsigned(text, 10) != value)
+				throw logic_error("the conversion didn't give back the same number");
+		});
+	});
+
+	Kernels::setThresholds(defaults);
+
+	ofstream file;
+
+	if (argc == 2)
+	{
+		file.open(argv[1]);
+
+		if (!file)
+		{
+			cerr << "can't write " << argv[1] << '\n';
+			return 1;
+		}
+	}
+
+	ostream &out = argc == 2 ? file : cout;
+	out << "// Thresholds for BigTuning.h measured by bigint_tune with the " << Kernels::implementation() << " kernels\n"
+		<< "#if BIGNUMBER_LIMB_BITS != " << Kernels::limbBits << "\n"
+		<< "#error \"these thresholds were measured with " << Kernels::limbBits << "-bit limbs\"\n"
+		<< "#endif\n\n"
+		<< "#define BIGNUMBER_MULTIPLY_THRESHOLD " << tuned.multiply << '\n'
+		<< "#define BIGNUMBER_SQUARE_THRESHOLD " << tuned.square << '\n'
+		<< "#define BIGNUMBER_CONVERSION_THRESHOLD " << tuned.conversion << '\n';
+
+	return out ? 0 : 1;
+}